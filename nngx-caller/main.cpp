@@ -5,10 +5,45 @@
 #include <array>
 #include <string>
 #include <random>
+#include <set>
 
 #include "nngx.h"
 #include "nngUtil.h"
 
+// TestMessage_Pod 使用的结构体：Schema 须在命名空间作用域特化
+typedef struct _POD_PLAIN
+{
+    uint32_t _X;
+    uint16_t _Y;
+} POD_PLAIN, * PPOD_PLAIN;
+
+typedef struct _POD_ITEM
+{
+    uint32_t _Price;
+    uint8_t _Qty;
+} POD_ITEM, * PPOD_ITEM;
+
+typedef struct _POD_ORDER
+{
+    uint64_t _Id;
+    POD_ITEM _Item;
+    uint16_t _Levels[2];
+    char _Tag[4];
+    uint32_t _Raw;
+} POD_ORDER, * PPOD_ORDER;
+
+template <>
+struct nng::Schema<POD_ITEM>
+{
+    using fields = Fields<Field<&POD_ITEM::_Price>, Field<&POD_ITEM::_Qty>>;
+};
+
+template <>
+struct nng::Schema<POD_ORDER>
+{
+    using fields = Fields<Field<&POD_ORDER::_Id>, Field<&POD_ORDER::_Item>, Field<&POD_ORDER::_Levels>, Field<&POD_ORDER::_Tag>, Field<&POD_ORDER::_Raw, FO_NATIVE>>;
+};
+
 class NngTester
 {
 public:
@@ -1104,7 +1139,1840 @@ public:
         printf("%s -> Passed\r\n", __FUNCTION__);
     }
 
+    static void TestMessage_RequestParallel()
+    {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                if (code == MSG_CODE0) {
+                    auto nIdx = msg.chop_u32();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                    msg.realloc(0);
+                    msg.append_u32(nIdx);
+                    return 0x44448888;
+                }
+
+                return {};
+            }
+        };
+
+        enum { PARALLEL = 10 };
+        MyResponseParallel mrp;
+        assert(mrp.start(m_szAddr, PARALLEL) == NNG_OK);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+        assert(request.set_parallel(PARALLEL) == NNG_OK);
+
+        // 10 个请求同时在途，总耗时应接近单个请求的处理时间
+        auto tpStart = std::chrono::steady_clock::now();
+        std::vector<std::future<Msg>> vecFutures;
+        for (uint32_t i(0); i < PARALLEL; ++i) {
+            Msg m(0);
+            m.append_u32(i);
+            vecFutures.push_back(request.async_send(MSG_CODE0, std::move(m)));
+        }
+
+        for (uint32_t i(0); i < PARALLEL; ++i) {
+            Msg m = vecFutures[i].get();
+            assert(Msg::_Chop_msg_result(m) == 0x44448888);
+            assert(m.chop_u32() == i);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - tpStart;
+        assert(elapsed < std::chrono::milliseconds(200 * PARALLEL / 2));
+
+        request.close();
+        mrp.close();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_LockFree() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                if (code == MSG_CODE0) {
+                    m_nCount++;
+                }
+                return {};
+            }
+
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+
+        Push<Listener> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+        assert(pusher.set_lock_free(1024) == NNG_OK);
+
+        MyPull puller;
+        assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+
+        enum { PRODUCER_COUNT = 16, DATA_COUNT = 1000 };
+        std::array<std::thread, PRODUCER_COUNT> arrProducers;
+        for (auto& th : arrProducers) {
+            th = std::thread(
+                [&pusher]
+                {
+                    for (size_t i(0); i < DATA_COUNT; ++i) {
+                        nng::Msg m(0);
+                        m.append_u32((uint32_t)i);
+                        pusher.async_send(MSG_CODE0, std::move(m));
+                    }
+                }
+            );
+        }
+
+        for (auto& th : arrProducers) {
+            th.join();
+        }
+
+        // 等待异步数据发送完成。
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        pusher.close();
+        puller.stop_dispatch();
+
+        assert(puller.m_nCount == PRODUCER_COUNT * DATA_COUNT);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_QueueLimit() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                if (code == MSG_CODE0) {
+                    m_nCount++;
+                }
+                return {};
+            }
+
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+
+        // 尚无接收方，消息全部滞留在发送队列中
+        Push<Listener> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+        pusher.set_queue_limit(4, 0, Push<Listener>::QP_FAIL);
+
+        for (size_t i(0); i < 4; ++i) {
+            Msg m(0);
+            m.append_u32((uint32_t)i);
+            assert(pusher.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+        }
+        assert(pusher.queue_depth() == 4);
+        assert(pusher.queue_bytes() > 0);
+        assert(pusher.async_send(MSG_CODE0, Msg(0)) == NNG_EAGAIN);
+
+        pusher.set_queue_limit(4, 0, Push<Listener>::QP_DROP_NEWEST);
+        assert(pusher.async_send(MSG_CODE0, Msg(0)) == NNG_OK);
+        assert(pusher.queue_dropped() == 1);
+
+        pusher.set_queue_limit(4, 0, Push<Listener>::QP_DROP_OLDEST);
+        assert(pusher.async_send(MSG_CODE0, Msg(0)) == NNG_OK);
+        assert(pusher.queue_dropped() == 2);
+        assert(pusher.queue_depth() == 4);
+
+        pusher.set_queue_limit(4, 0, Push<Listener>::QP_BLOCK, 100);
+        assert(pusher.async_send(MSG_CODE0, Msg(0)) == NNG_ETIMEDOUT);
+
+        // 接收方上线后队列排空
+        MyPull puller;
+        assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        assert(pusher.queue_depth() == 0);
+        assert(pusher.queue_bytes() == 0);
+
+        pusher.close();
+        puller.stop_dispatch();
+
+        assert(puller.m_nCount == 4);
+
+        // 无锁模式：QP_BLOCK 的提交方阻塞等待空位（不占用 CPU），接收方上线后全部发出
+        {
+            enum { THREAD_COUNT = 4, SEND_COUNT = 25 };
+            Push<Listener> ringPusher;
+            assert(ringPusher.start(m_szAddr) == NNG_OK);
+            assert(ringPusher.set_lock_free(16) == NNG_OK);
+            ringPusher.set_queue_limit(4, 0, Push<Listener>::QP_BLOCK, 100);
+
+            // 无锁模式下在途的消息不计入队列：先发出的消息在途，其后 4 条排队，再提交的等待 100 毫秒后超时
+            size_t nAccepted = 0;
+            int rv = NNG_OK;
+            while ((rv = ringPusher.async_send(MSG_CODE0, Msg(0))) == NNG_OK) {
+                assert(++nAccepted < 100);
+            }
+            assert(rv == NNG_ETIMEDOUT);
+            assert(ringPusher.queue_depth() == 4);
+
+            ringPusher.set_queue_limit(4, 0, Push<Listener>::QP_BLOCK);
+            std::vector<std::thread> vecThreads;
+            for (size_t t(0); t < THREAD_COUNT; ++t) {
+                vecThreads.emplace_back([&ringPusher] {
+                    for (size_t i(0); i < SEND_COUNT; ++i) {
+                        assert(ringPusher.async_send(MSG_CODE0, Msg(0)) == NNG_OK);
+                        assert(ringPusher.queue_depth() <= 4);
+                    }
+                });
+            }
+
+            MyPull ringPuller;
+            assert(ringPuller.start_dispatch(m_szAddr) == NNG_OK);
+            for (auto& t : vecThreads) {
+                t.join();
+            }
+            for (size_t i(0); i < 100 && ringPuller.m_nCount < nAccepted + THREAD_COUNT * SEND_COUNT; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            assert(ringPuller.m_nCount == nAccepted + THREAD_COUNT * SEND_COUNT);
+            assert(ringPusher.queue_depth() == 0);
+
+            ringPusher.close();
+            ringPuller.stop_dispatch();
+        }
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_Batch() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+            MSG_CODE1 = 0x2,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                if (code == MSG_CODE0 || code == MSG_CODE1) {
+                    m_nCount++;
+                }
+                return {};
+            }
+
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+
+        enum { DATA_COUNT = 2000 };
+        for (bool bLockFree : { false, true }) {
+            Push<Listener> pusher;
+            assert(pusher.start(m_szAddr) == NNG_OK);
+            if (bLockFree) {
+                assert(pusher.set_lock_free(DATA_COUNT / 4) == NNG_OK);
+            }
+
+            MyPull puller;
+            assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+
+            std::vector<Msg> vecMsgs(DATA_COUNT);
+            for (size_t i(0); i < DATA_COUNT; ++i) {
+                vecMsgs[i] = Msg(0);
+                vecMsgs[i].append_u32((uint32_t)i);
+            }
+            assert(pusher.async_send_batch(MSG_CODE0, vecMsgs) == NNG_OK);
+            for (auto& m : vecMsgs) {
+                assert(!m.valid());
+            }
+
+            std::vector<std::pair<Msg::_Ty_msg_code, Msg>> vecPairs(DATA_COUNT);
+            for (size_t i(0); i < DATA_COUNT; ++i) {
+                vecPairs[i].first = MSG_CODE1;
+                vecPairs[i].second = Msg(0);
+                vecPairs[i].second.append_u32((uint32_t)i);
+            }
+            assert(pusher.async_send_batch(vecPairs) == NNG_OK);
+
+            // 等待异步数据发送完成。
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            pusher.close();
+            puller.stop_dispatch();
+
+            assert(puller.m_nCount == DATA_COUNT * 2);
+        }
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_SendParallel() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                if (code == MSG_CODE0) {
+                    m_nCount++;
+                }
+                return {};
+            }
+
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+        class MyPair : public Service<Pair<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                if (code == MSG_CODE0) {
+                    // 单管道协议上保持发送顺序
+                    assert(msg.chop_u32() == m_nCount);
+                    m_nCount++;
+                }
+                return {};
+            }
+
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+
+        enum { PULLER_COUNT = 8, PARALLEL = 8, DATA_COUNT = 4000 };
+        Push<Listener> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+        assert(pusher.set_send_parallel(PARALLEL) == NNG_OK);
+        assert(pusher.set_send_parallel(PARALLEL) == NNG_EBUSY);
+
+        std::array<MyPull, PULLER_COUNT> arrPullers;
+        for (auto& puller : arrPullers) {
+            assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        for (size_t i(0); i < DATA_COUNT; ++i) {
+            Msg m(0);
+            m.append_u32((uint32_t)i);
+            assert(pusher.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+        }
+
+        // 等待异步数据发送完成。
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        pusher.close();
+
+        size_t nTotal = 0;
+        for (auto& puller : arrPullers) {
+            puller.stop_dispatch();
+            nTotal += puller.m_nCount;
+        }
+        assert(nTotal == DATA_COUNT);
+
+        Pair<Listener> pairSender;
+        assert(pairSender.start(m_szAddr) == NNG_OK);
+        assert(pairSender.set_send_parallel(PARALLEL) == NNG_OK);
+
+        MyPair pairReceiver;
+        assert(pairReceiver.start_dispatch(m_szAddr) == NNG_OK);
+
+        for (size_t i(0); i < DATA_COUNT; ++i) {
+            Msg m(0);
+            m.append_u32((uint32_t)i);
+            assert(pairSender.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        pairSender.close();
+        pairReceiver.stop_dispatch();
+        assert(pairReceiver.m_nCount == DATA_COUNT);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_RequestCallback()
+    {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                if (code == MSG_CODE0) {
+                    auto nIdx = msg.chop_u32();
+                    msg.realloc(0);
+                    msg.append_u32(nIdx);
+                    return 0x44448888;
+                }
+
+                return {};
+            }
+        };
+
+        enum { PARALLEL = 8, REQUEST_COUNT = 1000 };
+        MyResponseParallel mrp;
+        assert(mrp.start(m_szAddr, PARALLEL) == NNG_OK);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+        assert(request.set_parallel(PARALLEL) == NNG_OK);
+
+        // 回复通过回调返回，不分配 promise，也不阻塞线程
+        std::atomic<size_t> nReplied = 0;
+        std::latch latDone(REQUEST_COUNT);
+        for (uint32_t i(0); i < REQUEST_COUNT; ++i) {
+            Msg m(0);
+            m.append_u32(i);
+            assert(request.async_send(MSG_CODE0, std::move(m),
+                [i, &nReplied, &latDone](nng_err e, Msg&& reply)
+                {
+                    assert(e == NNG_OK);
+                    assert(Msg::_Chop_msg_result(reply) == 0x44448888);
+                    assert(reply.chop_u32() == i);
+                    nReplied++;
+                    latDone.count_down();
+                }) == NNG_OK);
+        }
+
+        latDone.wait();
+        assert(nReplied == REQUEST_COUNT);
+
+        request.close();
+        mrp.close();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_Coroutine()
+    {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                if (code == MSG_CODE0) {
+                    auto nIdx = msg.chop_u32();
+                    msg.realloc(0);
+                    msg.append_u32(nIdx);
+                    return 0x44448888;
+                }
 
+                return {};
+            }
+        };
+        class ListenerRespond : public Service<Respond<>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                msg.realloc(0);
+                return 0x44488800;
+            }
+        };
+        class Flows
+        {
+        public:
+            static Detached Call(Request& request, uint32_t nIdx, std::atomic<size_t>& nPassed, std::latch& latDone) {
+                Msg m(0);
+                m.append_u32(nIdx);
+                auto result = co_await request.async_call(MSG_CODE0, m);
+                assert(result == 0x44448888);
+                assert(m.chop_u32() == nIdx);
+                nPassed++;
+                latDone.count_down();
+            }
+
+            static Detached Recv(Pull<Dialer>& pull, size_t nCount, std::atomic<size_t>& nPassed, std::latch& latDone) {
+                for (size_t i(0); i < nCount; ++i) {
+                    Msg m = co_await pull.async_recv();
+                    assert(m.chop_u32() == i);
+                    nPassed++;
+                }
+                latDone.count_down();
+            }
+
+            static Detached Collect(Survey<>& survey, size_t nRespond, std::atomic<size_t>& nPassed, std::latch& latDone) {
+                auto vecReplies = co_await survey.async_collect(MSG_CODE0, Msg(0), nRespond);
+                for (Msg& m : vecReplies) {
+                    assert(Msg::_Chop_msg_result(m) == 0x44488800);
+                    nPassed++;
+                }
+                latDone.count_down();
+            }
+        };
+
+        // 上千个请求流同时在途，不占用阻塞线程
+        {
+            enum { PARALLEL = 16, FLOW_COUNT = 1000 };
+            MyResponseParallel mrp;
+            assert(mrp.start(m_szAddr, PARALLEL) == NNG_OK);
+
+            Request request;
+            assert(request.start(m_szAddr) == NNG_OK);
+
+            std::atomic<size_t> nPassed = 0;
+            std::latch latDone(FLOW_COUNT);
+            for (uint32_t i(0); i < FLOW_COUNT; ++i) {
+                Flows::Call(request, i, nPassed, latDone);
+            }
+            latDone.wait();
+            assert(nPassed == FLOW_COUNT);
+
+            request.close();
+            mrp.close();
+        }
+
+        // 套接字协程接收
+        {
+            enum { DATA_COUNT = 10 };
+            Pull<Dialer> pull;
+            Push<Listener> push;
+            assert(push.start(m_szAddr) == NNG_OK);
+            assert(pull.start(m_szAddr) == NNG_OK);
+
+            std::atomic<size_t> nPassed = 0;
+            std::latch latDone(1);
+            Flows::Recv(pull, DATA_COUNT, nPassed, latDone);
+            for (uint32_t i(0); i < DATA_COUNT; ++i) {
+                Msg m(0);
+                m.append_u32(i);
+                assert(push.async_send(std::move(m)) == NNG_OK);
+            }
+            latDone.wait();
+            assert(nPassed == DATA_COUNT);
+
+            push.close();
+            pull.close();
+        }
+
+        // 调查协程收集回复
+        {
+            enum { RESPOND_COUNT = 5 };
+            Survey<> survey;
+            assert(survey.start(m_szAddr) == NNG_OK);
+
+            ListenerRespond respond[RESPOND_COUNT];
+            for (auto& r : respond) {
+                assert(r.start_dispatch(m_szAddr) == NNG_OK);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+            std::atomic<size_t> nPassed = 0;
+            std::latch latDone(1);
+            Flows::Collect(survey, RESPOND_COUNT, nPassed, latDone);
+            latDone.wait();
+            assert(nPassed == RESPOND_COUNT);
+
+            survey.close();
+        }
+
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_RequestDeadline()
+    {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                msg.realloc(0);
+                return 0x44448888;
+            }
+        };
+
+        MyResponseParallel mrp;
+        assert(mrp.start(m_szAddr, 1) == NNG_OK);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+
+        auto fnError = [](std::future<Msg>& fut) -> nng_err {
+            try {
+                fut.get();
+                return NNG_OK;
+            }
+            catch (const Exception& e) {
+                return e.get_error();
+            }
+        };
+
+        // 排队中的请求到期后立即以 NNG_ETIMEDOUT 结束，不必等待前面的请求完成
+        auto tpStart = std::chrono::steady_clock::now();
+        Request::_Ty_send_handle hSlow = 0, hQueued = 0, hCanceled = 0;
+        auto futSlow = request.async_send(MSG_CODE0, Msg(0), NNG_DURATION_INFINITE, &hSlow);
+        auto futQueued = request.async_send(MSG_CODE0, Msg(0), 100, &hQueued);
+        auto futCanceled = request.async_send(MSG_CODE0, Msg(0), NNG_DURATION_INFINITE, &hCanceled);
+        assert(hSlow != hQueued && hQueued != hCanceled);
+
+        assert(request.cancel(hCanceled) == NNG_OK);
+        assert(fnError(futCanceled) == NNG_ECANCELED);
+
+        assert(fnError(futQueued) == NNG_ETIMEDOUT);
+        assert(std::chrono::steady_clock::now() - tpStart < std::chrono::milliseconds(250));
+
+        assert(fnError(futSlow) == NNG_OK);
+        assert(request.cancel(hSlow) == NNG_ENOENT);
+
+        // 在途的请求由 aio 超时结束；未带句柄的请求不能以句柄 0 取消
+        auto futInflight = request.async_send(MSG_CODE0, Msg(0), 100);
+        assert(request.cancel(0) == NNG_ENOENT);
+        assert(fnError(futInflight) == NNG_ETIMEDOUT);
+
+        // 无锁模式：尚在环形队列中的请求不能取消，在途的请求可以取消
+        {
+            Request ringRequest;
+            assert(ringRequest.start(m_szAddr) == NNG_OK);
+            assert(ringRequest.set_lock_free(16) == NNG_OK);
+
+            Request::_Ty_send_handle hRingInflight = 0, hRingQueued = 0;
+            auto futRingInflight = ringRequest.async_send(MSG_CODE0, Msg(0), NNG_DURATION_INFINITE, &hRingInflight);
+            auto futRingQueued = ringRequest.async_send(MSG_CODE0, Msg(0), NNG_DURATION_INFINITE, &hRingQueued);
+            assert(ringRequest.cancel(hRingQueued) == NNG_ENOTSUP);
+            assert(ringRequest.cancel(hRingInflight) == NNG_OK);
+            assert(fnError(futRingInflight) == NNG_ECANCELED);
+            assert(fnError(futRingQueued) == NNG_OK);
+            assert(ringRequest.cancel(hRingInflight) == NNG_ENOTSUP);
+            ringRequest.close();
+        }
+
+        request.close();
+        mrp.close();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_Priority() {
+        using namespace nng;
+        enum {
+            MSG_CODE_BULK = 0x1,
+            MSG_CODE_CONTROL = 0x2,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_vecCodes.push_back(code);
+                return {};
+            }
+
+        public:
+            std::mutex m_mtx;
+            std::vector<Msg::_Ty_msg_code> m_vecCodes;
+        };
+
+        // 尚无接收方时积压批量消息，之后提交的控制消息应越过积压
+        auto fnRun = [](Push<Listener>::LANE_POLICY policy, size_t nBulk, size_t nControl) {
+            Push<Listener> pusher;
+            assert(pusher.start(m_szAddr) == NNG_OK);
+            pusher.set_priority_policy(policy, 1, 1);
+            for (size_t i(0); i < nBulk; ++i) {
+                assert(pusher.async_send(MSG_CODE_BULK, Msg(0)) == NNG_OK);
+            }
+            for (size_t i(0); i < nControl; ++i) {
+                assert(pusher.async_send(Push<Listener>::PRIORITY::HIGH, MSG_CODE_CONTROL, Msg(0)) == NNG_OK);
+            }
+
+            MyPull puller;
+            assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            pusher.close();
+            puller.stop_dispatch();
+
+            assert(puller.m_vecCodes.size() == nBulk + nControl);
+            return puller.m_vecCodes;
+        };
+
+        // 严格优先：第一条批量消息已在途，控制消息紧随其后
+        auto vecStrict = fnRun(Push<Listener>::LP_STRICT, 16, 1);
+        assert(vecStrict[0] == MSG_CODE_BULK && vecStrict[1] == MSG_CODE_CONTROL);
+
+        // 加权轮转（1:1）：两个通道交替发送
+        auto vecWeighted = fnRun(Push<Listener>::LP_WEIGHTED, 4, 3);
+        std::vector<Msg::_Ty_msg_code> vecExpected = {
+            MSG_CODE_BULK, MSG_CODE_CONTROL, MSG_CODE_BULK, MSG_CODE_CONTROL, MSG_CODE_BULK, MSG_CODE_CONTROL, MSG_CODE_BULK
+        };
+        assert(vecWeighted == vecExpected);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_Coalesce() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+        };
+        class MyPull : public ServiceAio<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                // 拆分后的消息与发送时相同，且保持顺序
+                assert(code == MSG_CODE0);
+                assert(msg.len() == sizeof(uint32_t) + 64);
+                assert(msg.trim_u32() == m_nCount);
+                m_nCount++;
+                return {};
+            }
+
+        public:
+            std::atomic<uint32_t> m_nCount = 0;
+        };
+
+        MyPull puller;
+        puller.set_coalesce_unpack();
+        assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+
+        Push<Dialer> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+        assert(pusher.set_coalesce(16 * 1024, 1) == NNG_OK);
+
+        const uint32_t nTotal = 10000;
+        std::string sPadding(64, 'x');
+        for (uint32_t i(0); i < nTotal; ++i) {
+            Msg m(0);
+            m.append_u32(i);
+            m.append(sPadding.data(), sPadding.size());
+            assert(pusher.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+        }
+
+        for (size_t i(0); i < 100 && puller.m_nCount < nTotal; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(puller.m_nCount == nTotal);
+        assert(pusher.queue_depth() == 0);
+
+        pusher.close();
+        puller.stop_dispatch();
+
+        // 未开启拆分时，末尾恰为合并消息代码的普通消息原样处理；开启后帧格式错误的合并消息被丢弃并报告 NNG_EPROTO
+        class MyStrictPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual bool _On_raw_message(Msg& msg) override final {
+                m_nRaw++;
+                return true;
+            }
+
+            virtual bool _On_dispatch_error(nng_err e) override final {
+                if (e == NNG_EPROTO) {
+                    m_nProto++;
+                    return false;
+                }
+                return Service<Pull<Dialer>>::_On_dispatch_error(e);
+            }
+
+        public:
+            std::atomic<size_t> m_nRaw = 0;
+            std::atomic<size_t> m_nProto = 0;
+        };
+
+        auto fnMalformed = [] {
+            Msg m(0);
+            m.append_u32(100);
+            m.append_u32(0);
+            Msg::_Append_msg_code(m, Msg::_MSG_CODE_PACKED);
+            return m;
+        };
+
+        for (bool bUnpack : { false, true }) {
+            MyStrictPull strict;
+            strict.set_coalesce_unpack(bUnpack);
+            assert(strict.coalesce_unpack() == bUnpack);
+            assert(strict.start_dispatch(m_szAddr) == NNG_OK);
+
+            Push<Dialer> sender;
+            assert(sender.start(m_szAddr) == NNG_OK);
+            assert(sender.async_send(fnMalformed()) == NNG_OK);
+            assert(sender.async_send(MSG_CODE0, Msg(0)) == NNG_OK);
+
+            for (size_t i(0); i < 100 && strict.m_nRaw + strict.m_nProto < 2; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            assert(strict.m_nProto == (bUnpack ? 1 : 0));
+            assert(strict.m_nRaw == (bUnpack ? 1 : 2));
+
+            sender.close();
+            strict.stop_dispatch();
+        }
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_DispatchTimeout() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+        };
+        class MyPull : public Pull<Dialer>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                if (code == MSG_CODE0) {
+                    m_nCount++;
+                }
+                return {};
+            }
+
+            // 接收超时只是一次分支判断，用来执行周期性工作
+            virtual bool _On_dispatch_error(nng_err e) override final {
+                if (e == NNG_ETIMEDOUT) {
+                    return ++m_nTimeouts >= 20;
+                }
+                return Pull<Dialer>::_On_dispatch_error(e);
+            }
+
+            virtual bool _On_dispatch_exception(const Exception& e) override final {
+                m_nExceptions++;
+                return true;
+            }
+
+        public:
+            size_t m_nCount = 0;
+            size_t m_nTimeouts = 0;
+            size_t m_nExceptions = 0;
+        };
+
+        Push<Listener> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+        for (size_t i(0); i < 3; ++i) {
+            assert(pusher.async_send(MSG_CODE0, Msg(0)) == NNG_OK);
+        }
+
+        MyPull puller;
+        assert(puller.start(m_szAddr) == NNG_OK);
+        assert(puller.set_recv_timeout(5) == NNG_OK);
+        puller.dispatch();
+
+        assert(puller.m_nCount == 3);
+        assert(puller.m_nTimeouts == 20);
+        assert(puller.m_nExceptions == 0);
+
+        pusher.close();
+        puller.close();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_RequestResponse_ServiceThreads() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class ListenerRespnose : public Service<Response>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                size_t nActive = ++m_nActive;
+                size_t nMax = m_nMaxActive;
+                while (nActive > nMax && !m_nMaxActive.compare_exchange_weak(nMax, nActive)) {}
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                m_nActive--;
+                m_nCount++;
+                return code + 1;
+            }
+        public:
+            std::atomic<size_t> m_nCount = 0;
+            std::atomic<size_t> m_nActive = 0;
+            std::atomic<size_t> m_nMaxActive = 0;
+        };
+
+        // 4 个调度线程各自使用一个 Ctx，阻塞式的处理回调可以同时处理 4 个请求
+        ListenerRespnose response;
+        assert(response.start_dispatch(m_szAddr, 0, (size_t)4) == NNG_OK);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+        assert(request.set_parallel(4) == NNG_OK);
+
+        auto tpStart = std::chrono::steady_clock::now();
+        std::vector<std::future<Msg>> vecFutures;
+        for (size_t i(0); i < 4; ++i) {
+            vecFutures.push_back(request.async_send(MSG_CODE0, Msg(0)));
+        }
+        for (auto& fut : vecFutures) {
+            Msg m = fut.get();
+            assert(Msg::_Chop_msg_result(m) == MSG_CODE0 + 1);
+        }
+        assert(std::chrono::steady_clock::now() - tpStart < std::chrono::milliseconds(600));
+
+        request.close();
+        assert(response.stop_dispatch());
+        assert(!response.joinable());
+        assert(response.m_nCount == 4);
+        assert(response.m_nMaxActive > 1);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_RequestResponse_ServiceAioParallel() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class ListenerRespnose : public ServiceAio<Response>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                size_t nActive = ++m_nActive;
+                size_t nMax = m_nMaxActive;
+                while (nActive > nMax && !m_nMaxActive.compare_exchange_weak(nMax, nActive)) {}
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                m_nActive--;
+                m_nCount++;
+                return code + 1;
+            }
+        public:
+            std::atomic<size_t> m_nCount = 0;
+            std::atomic<size_t> m_nActive = 0;
+            std::atomic<size_t> m_nMaxActive = 0;
+        };
+
+        // 4 个 Ctx + Aio 工作项，同时处理 4 个请求
+        ListenerRespnose response;
+        assert(response.start_dispatch(m_szAddr, 0, (size_t)4) == NNG_OK);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+        assert(request.set_parallel(4) == NNG_OK);
+
+        for (size_t nRound(0); nRound < 2; ++nRound) {
+            auto tpStart = std::chrono::steady_clock::now();
+            std::vector<std::future<Msg>> vecFutures;
+            for (size_t i(0); i < 4; ++i) {
+                vecFutures.push_back(request.async_send(MSG_CODE0, Msg(0)));
+            }
+            for (auto& fut : vecFutures) {
+                Msg m = fut.get();
+                assert(Msg::_Chop_msg_result(m) == MSG_CODE0 + 1);
+            }
+            assert(std::chrono::steady_clock::now() - tpStart < std::chrono::milliseconds(600));
+        }
+
+        request.close();
+        assert(response.stop_dispatch());
+        assert(!response.is_running());
+        assert(response.m_nCount == 8);
+        assert(response.m_nMaxActive > 1);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_ContextParallel() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        class MyResponseParallel : public ContextParallel<ProtocolRep, Listener>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                auto nIdx = msg.chop_u32();
+                msg.realloc(0);
+                msg.append_u32(nIdx);
+                return 0x44448888;
+            }
+        };
+        class MyRequestParallel : public ContextParallel<ProtocolReq, Dialer>
+        {
+        private:
+            // Req 协议：code 为请求的消息代码，据此区分在途请求的回复
+            virtual void _On_reply(Msg::_Ty_msg_code code, Msg::_Ty_msg_result res, Msg& msg, nng_duration& _Wait_ms) override {
+                assert(res == 0x44448888);
+                auto nIdx = msg.chop_u32();
+                assert(code == (Msg::_Ty_msg_code)MSG_CODE0 + nIdx);
+                m_nSum += nIdx;
+                m_nCount++;
+            }
+        public:
+            std::atomic<size_t> m_nCount = 0;
+            std::atomic<size_t> m_nSum = 0;
+        };
+        class MySubscriberParallel : public ContextParallel<ProtocolSub, Dialer>
+        {
+        private:
+            // 订阅属于各个 Ctx
+            virtual int _On_dispatch_ctx(const Ctx& ctx) override {
+                return ctx.subscribe("", 0);
+            }
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                if (code == MSG_CODE0) {
+                    m_nCount++;
+                }
+                return {};
+            }
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+
+        // Req 客户端流水线：8 个 Ctx 同时在途
+        {
+            enum { PARALLEL = 8, REQUEST_COUNT = 100 };
+            MyResponseParallel mrp;
+            assert(mrp.start(m_szAddr, PARALLEL) == NNG_OK);
+
+            MyRequestParallel mreq;
+            assert(mreq.start(m_szAddr, PARALLEL) == NNG_OK);
+
+            size_t nSum = 0;
+            for (uint32_t i(0); i < REQUEST_COUNT; ++i) {
+                Msg m(0);
+                m.append_u32(i);
+                assert(mreq.async_send((Msg::_Ty_msg_code)MSG_CODE0 + i, std::move(m)) == NNG_OK);
+                nSum += i;
+            }
+            for (size_t i(0); i < 100 && mreq.m_nCount < REQUEST_COUNT; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            assert(mreq.m_nCount == REQUEST_COUNT);
+            assert(mreq.m_nSum == nSum);
+
+            mreq.close();
+            mrp.close();
+        }
+
+        // Req 请求失败：服务端放弃回复，Ctx 接收超时后按请求报告失败
+        {
+            class MySilentResponseParallel : public ContextParallel<ProtocolRep, Listener>
+            {
+            private:
+                virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                    // 令牌随即销毁，放弃回复
+                    ReplyToken token = _Defer_reply(msg);
+                    return {};
+                }
+            };
+            class MyFailingRequestParallel : public ContextParallel<ProtocolReq, Dialer>
+            {
+            private:
+                virtual int _On_dispatch_ctx(const Ctx& ctx) override {
+                    return ctx.set_ms(NNG_OPT_RECVTIMEO, 50);
+                }
+                virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                    m_nReplies++;
+                    return {};
+                }
+                virtual void _On_request_failed(Msg::_Ty_msg_code code, Msg& request, nng_err e) override {
+                    assert(e == NNG_ETIMEDOUT && !request);
+                    std::scoped_lock locker(m_mtx);
+                    m_setFailed.insert(code);
+                }
+            public:
+                std::mutex m_mtx;
+                std::set<Msg::_Ty_msg_code> m_setFailed;
+                std::atomic<size_t> m_nReplies = 0;
+            };
+
+            enum { PARALLEL = 2, REQUEST_COUNT = 4 };
+            MySilentResponseParallel mrp;
+            assert(mrp.start(m_szAddr, PARALLEL) == NNG_OK);
+
+            MyFailingRequestParallel mreq;
+            assert(mreq.start(m_szAddr, PARALLEL) == NNG_OK);
+            for (uint32_t i(0); i < REQUEST_COUNT; ++i) {
+                assert(mreq.async_send((Msg::_Ty_msg_code)MSG_CODE0 + i, Msg(0)) == NNG_OK);
+            }
+            for (size_t i(0); i < 100; ++i) {
+                {
+                    std::scoped_lock locker(mreq.m_mtx);
+                    if (mreq.m_setFailed.size() == REQUEST_COUNT) {
+                        break;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            {
+                std::scoped_lock locker(mreq.m_mtx);
+                assert(mreq.m_setFailed.size() == REQUEST_COUNT);
+                assert(*mreq.m_setFailed.begin() == MSG_CODE0 && *mreq.m_setFailed.rbegin() == (Msg::_Ty_msg_code)MSG_CODE0 + REQUEST_COUNT - 1);
+            }
+            assert(mreq.m_nReplies == 0);
+
+            mreq.close();
+            mrp.close();
+        }
+
+        // Sub 并行消费
+        {
+            enum { PARALLEL = 4, MESSAGE_COUNT = 20 };
+            Publisher publisher;
+            assert(publisher.start(m_szAddr) == NNG_OK);
+
+            MySubscriberParallel msub;
+            assert(msub.start(m_szAddr, PARALLEL) == NNG_OK);
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+            for (size_t i(0); i < MESSAGE_COUNT; ++i) {
+                assert(publisher.async_send(MSG_CODE0, Msg(0)) == NNG_OK);
+            }
+            for (size_t i(0); i < 100 && msub.m_nCount < MESSAGE_COUNT; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            assert(msub.m_nCount == MESSAGE_COUNT);
+
+            msub.close();
+            publisher.close();
+        }
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_ResponseParallel_DeferReply() {
+        using namespace nng;
+        enum {
+            MSG_CODE_DEFER = 0x345,
+            MSG_CODE_ABANDON,
+        };
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                if (code == MSG_CODE_ABANDON) {
+                    // 令牌未完成即销毁：不回复，工作项继续接收
+                    auto token = _Defer_reply(msg);
+                    return {};
+                }
+
+                // 模拟下游调用：在其它线程完成回复
+                auto nIdx = msg.chop_u32();
+                std::thread([token = _Defer_reply(msg), nIdx]() mutable {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                    Msg m(0);
+                    m.append_u32(nIdx);
+                    token.reply(std::move(m), 0x44448888);
+                }).detach();
+                return {};
+            }
+        };
+
+        enum { PARALLEL = 4 };
+        MyResponseParallel mrp;
+        assert(mrp.start(m_szAddr, PARALLEL) == NNG_OK);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+        assert(request.set_parallel(PARALLEL) == NNG_OK);
+
+        auto fut = request.async_send(MSG_CODE_ABANDON, Msg(0), 100);
+        try {
+            fut.get();
+            assert(false);
+        }
+        catch (const Exception& e) {
+            assert(e.get_error() == NNG_ETIMEDOUT);
+        }
+
+        auto tpStart = std::chrono::steady_clock::now();
+        std::vector<std::future<Msg>> vecFutures;
+        for (uint32_t i(0); i < PARALLEL; ++i) {
+            Msg m(0);
+            m.append_u32(i);
+            vecFutures.push_back(request.async_send(MSG_CODE_DEFER, std::move(m)));
+        }
+        for (uint32_t i(0); i < PARALLEL; ++i) {
+            Msg m = vecFutures[i].get();
+            assert(Msg::_Chop_msg_result(m) == 0x44448888);
+            assert(m.chop_u32() == i);
+        }
+        assert(std::chrono::steady_clock::now() - tpStart < std::chrono::milliseconds(600));
+
+        request.close();
+        mrp.close();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_ResponseParallel_Autoscale() {
+        using namespace nng;
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            // 慢处理：消息积压时应自动增加工作项
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                size_t nActive = active_items();
+                size_t nMax = m_nMaxActive.load();
+                while (nActive > nMax && !m_nMaxActive.compare_exchange_weak(nMax, nActive));
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                auto nIdx = msg.chop_u32();
+                msg.realloc(0);
+                msg.append_u32(nIdx);
+                return 0x44448888;
+            }
+        public:
+            std::atomic<size_t> m_nMaxActive = 0;
+        };
+
+        enum { MIN_ITEMS = 1, MAX_ITEMS = 4, REQUEST_COUNT = 32 };
+        MyResponseParallel mrp;
+        assert(mrp.set_autoscale(0, MAX_ITEMS) == NNG_EINVAL);
+        assert(mrp.set_autoscale(MIN_ITEMS, MAX_ITEMS, 100) == NNG_OK);
+        assert(mrp.start(m_szAddr, 8) == NNG_OK);
+        assert(mrp.active_items() == MAX_ITEMS);
+        assert(mrp.set_autoscale(MIN_ITEMS, MAX_ITEMS) == NNG_EBUSY);
+
+        Request request;
+        assert(request.start(m_szAddr) == NNG_OK);
+        assert(request.set_parallel(8) == NNG_OK);
+
+        // 空闲后回收到下限
+        for (size_t i(0); i < 50 && mrp.active_items() > MIN_ITEMS; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        assert(mrp.active_items() == MIN_ITEMS);
+
+        // 积压时扩容，但不超过上限
+        std::vector<std::future<Msg>> vecFutures;
+        for (uint32_t i(0); i < REQUEST_COUNT; ++i) {
+            Msg m(0);
+            m.append_u32(i);
+            vecFutures.push_back(request.async_send(0x1, std::move(m)));
+        }
+        for (uint32_t i(0); i < REQUEST_COUNT; ++i) {
+            Msg m = vecFutures[i].get();
+            assert(Msg::_Chop_msg_result(m) == 0x44448888);
+            assert(m.chop_u32() == i);
+        }
+        assert(mrp.m_nMaxActive > MIN_ITEMS);
+        assert(mrp.m_nMaxActive <= MAX_ITEMS);
+
+        // 再次空闲后回收到下限
+        for (size_t i(0); i < 50 && mrp.active_items() > MIN_ITEMS; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        assert(mrp.active_items() == MIN_ITEMS);
+
+        request.close();
+        mrp.close();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_Executor() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x345,
+        };
+        // 统计投递次数的执行器，实际交给 ThreadPool 运行
+        class CountingExecutor : public Executor
+        {
+        public:
+            explicit CountingExecutor(Executor& executor) : m_executor(executor) {}
+            virtual int post(Task&& task) noexcept override {
+                m_nPosted++;
+                return m_executor.post(std::move(task));
+            }
+        public:
+            Executor& m_executor;
+            std::atomic<size_t> m_nPosted = 0;
+        };
+        class ListenerRespnose : public ServiceAio<Response>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                return code + 1;
+            }
+        };
+        class MyResponseParallel : public ResponseParallel
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                return code + 2;
+            }
+        };
+
+        // 线程池：工作线程内投递的任务同样执行，stop 前执行完全部任务
+        {
+            enum { TASK_COUNT = 1000 };
+            std::atomic<size_t> nCount = 0;
+            ThreadPool pool;
+            assert(pool.post([]() {}) == NNG_ECLOSED);
+            assert(pool.start(4) == NNG_OK);
+            assert(pool.start(4) == NNG_EBUSY);
+            assert(pool.size() == 4);
+            for (size_t i(0); i < TASK_COUNT; ++i) {
+                assert(pool.post([&nCount, &pool]() {
+                    nCount++;
+                    assert(pool.post([&nCount]() { nCount++; }) == NNG_OK);
+                }) == NNG_OK);
+            }
+            for (size_t i(0); i < 100 && nCount < TASK_COUNT * 2; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            assert(nCount == TASK_COUNT * 2);
+
+            // stop 前已投递的任务全部执行
+            for (size_t i(0); i < TASK_COUNT; ++i) {
+                assert(pool.post([&nCount]() { nCount++; }) == NNG_OK);
+            }
+            pool.stop();
+            assert(nCount == TASK_COUNT * 3);
+            assert(pool.post([]() {}) == NNG_ECLOSED);
+        }
+
+        enum { REQUEST_COUNT = 32 };
+        ThreadPool pool(4);
+
+        // ServiceAio：消息处理在线程池中运行，回复由工作线程发起
+        {
+            CountingExecutor executor(pool);
+            ListenerRespnose response;
+            assert(response.set_executor(&executor) == NNG_OK);
+            assert(response.start_dispatch(m_szAddr, 0, (size_t)4) == NNG_OK);
+            assert(response.set_executor(nullptr) == NNG_EBUSY);
+
+            Request request;
+            assert(request.start(m_szAddr) == NNG_OK);
+            assert(request.set_parallel(4) == NNG_OK);
+
+            std::vector<std::future<Msg>> vecFutures;
+            for (size_t i(0); i < REQUEST_COUNT; ++i) {
+                vecFutures.push_back(request.async_send(MSG_CODE0, Msg(0)));
+            }
+            for (auto& fut : vecFutures) {
+                Msg m = fut.get();
+                assert(Msg::_Chop_msg_result(m) == MSG_CODE0 + 1);
+            }
+            assert(executor.m_nPosted == REQUEST_COUNT);
+
+            request.close();
+            assert(response.stop_dispatch());
+        }
+
+        // ContextParallel：同上
+        {
+            CountingExecutor executor(pool);
+            MyResponseParallel mrp;
+            assert(mrp.set_executor(&executor) == NNG_OK);
+            assert(mrp.start(m_szAddr, 4) == NNG_OK);
+            assert(mrp.set_executor(nullptr) == NNG_EBUSY);
+
+            Request request;
+            assert(request.start(m_szAddr) == NNG_OK);
+            assert(request.set_parallel(4) == NNG_OK);
+
+            std::vector<std::future<Msg>> vecFutures;
+            for (size_t i(0); i < REQUEST_COUNT; ++i) {
+                vecFutures.push_back(request.async_send(MSG_CODE0, Msg(0)));
+            }
+            for (auto& fut : vecFutures) {
+                Msg m = fut.get();
+                assert(Msg::_Chop_msg_result(m) == MSG_CODE0 + 2);
+            }
+            assert(executor.m_nPosted == REQUEST_COUNT);
+
+            request.close();
+            mrp.close();
+        }
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_KeyOrdered() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+            KEY_COUNT = 16,
+        };
+        class MyPull : public ServiceAio<Pull<Dialer>>
+        {
+        private:
+            // 消息体开头的 u32 为键
+            virtual uint64_t _On_dispatch_key(const Msg& msg) override final {
+                auto p = (const uint8_t*)msg.body();
+                return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+            }
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                // 同一键的消息保持顺序
+                assert(code == MSG_CODE0);
+                uint32_t nKey = msg.trim_u32();
+                uint32_t nSeq = msg.trim_u32();
+                assert(nKey < KEY_COUNT);
+                assert(m_arrNext[nKey] == nSeq);
+                m_arrNext[nKey]++;
+                {
+                    std::scoped_lock locker(m_mtx);
+                    m_setThreads.insert(std::this_thread::get_id());
+                }
+                m_nCount++;
+                return {};
+            }
+
+        public:
+            std::atomic<uint32_t> m_arrNext[KEY_COUNT] = {};
+            std::atomic<uint32_t> m_nCount = 0;
+            std::mutex m_mtx;
+            std::set<std::thread::id> m_setThreads;
+        };
+
+        MyPull puller;
+        assert(puller.set_key_ordered(0) == NNG_EINVAL);
+        assert(puller.set_key_ordered(4, 64) == NNG_OK);
+        assert(puller.set_key_ordered(4) == NNG_EBUSY);
+        assert(puller.key_ordered());
+        assert(puller.start_dispatch(m_szAddr, 0, (size_t)4) == NNG_OK);
+
+        Push<Dialer> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+
+        const uint32_t nRounds = 500;
+        for (uint32_t i(0); i < nRounds; ++i) {
+            for (uint32_t nKey(0); nKey < KEY_COUNT; ++nKey) {
+                Msg m(0);
+                m.append_u32(nKey);
+                m.append_u32(i);
+                assert(pusher.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+            }
+        }
+
+        for (size_t i(0); i < 100 && puller.m_nCount < nRounds * KEY_COUNT; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(puller.m_nCount == nRounds * KEY_COUNT);
+        for (uint32_t nKey(0); nKey < KEY_COUNT; ++nKey) {
+            assert(puller.m_arrNext[nKey] == nRounds);
+        }
+        assert(puller.m_setThreads.size() > 1);
+
+        pusher.close();
+        puller.stop_dispatch();
+        puller.stop_key_ordered();
+        assert(!puller.key_ordered());
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_BatchDispatch() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+            MAX_BATCH = 64,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual void _On_batch(std::span<Msg> msgs) override final {
+                assert(!msgs.empty() && msgs.size() <= MAX_BATCH);
+                for (auto& msg : msgs) {
+                    assert(Msg::_Chop_msg_code(msg) == MSG_CODE0);
+                    assert(msg.trim_u32() == m_nCount);
+                    m_nCount++;
+                }
+                if (msgs.size() > m_nMaxBatch) {
+                    m_nMaxBatch = msgs.size();
+                }
+                m_nBatches++;
+
+                // 第一批处理较慢，使后续消息排队
+                if (m_nBatches == 1) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                }
+            }
+
+        public:
+            std::atomic<uint32_t> m_nCount = 0;
+            std::atomic<size_t> m_nBatches = 0;
+            std::atomic<size_t> m_nMaxBatch = 0;
+        };
+
+        MyPull puller;
+        assert(puller.set_batch(MAX_BATCH, 0, 10) == NNG_OK);
+        assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+
+        Push<Dialer> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+
+        const uint32_t nTotal = 1000;
+        for (uint32_t i(0); i < nTotal; ++i) {
+            Msg m(0);
+            m.append_u32(i);
+            assert(pusher.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+        }
+
+        for (size_t i(0); i < 100 && puller.m_nCount < nTotal; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(puller.m_nCount == nTotal);
+        assert(puller.m_nMaxBatch > 1);
+        assert(puller.m_nBatches < nTotal);
+
+        pusher.close();
+        puller.stop_dispatch();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestRawMessage_PushPull_Router() {
+        using namespace nng;
+        enum {
+            MSG_CODE_SYNC = 0x1,
+            MSG_CODE_ASYNC,
+            MSG_CODE_COUNT = 0x10,
+            MSG_CODE_PLUGIN = 0x123456789ull,
+        };
+        class MyPull : public ServiceAio<Pull<Dialer>>
+        {
+        public:
+            MyPull() {
+                // 插件在运行期注册
+                assert(m_routeMap.add(MSG_CODE_PLUGIN, [this](Msg& msg) -> Msg::_Ty_msg_result {
+                    m_nCountPlugin++;
+                    return {};
+                }) == NNG_OK);
+            }
+
+        private:
+            void OnSync(Msg& msg) {
+                assert(msg.trim_string() == "Hello World! Sync!");
+                m_nCountSync++;
+            }
+            void OnAsync(Msg& msg) {
+                assert(msg.trim_string() == "Hello World! Async!");
+                m_nCountAsync++;
+            }
+            Msg::_Ty_msg_result OnCount(Msg& msg) {
+                m_nSum += msg.trim_u32();
+                return {};
+            }
+
+            using Routes = Router<
+                Handler<MSG_CODE_SYNC, &MyPull::OnSync>,
+                Handler<MSG_CODE_ASYNC, &MyPull::OnAsync>,
+                Handler<MSG_CODE_COUNT, &MyPull::OnCount>>;
+
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                Msg::_Ty_msg_result result = {};
+                if (!Routes::route(*this, code, msg, result) && !m_routeMap.route(code, msg, result)) {
+                    m_nCountUnknown++;
+                }
+                return result;
+            }
+
+        public:
+            RouteMap m_routeMap;
+            std::atomic<size_t> m_nCountSync = 0;
+            std::atomic<size_t> m_nCountAsync = 0;
+            std::atomic<size_t> m_nCountPlugin = 0;
+            std::atomic<size_t> m_nCountUnknown = 0;
+            std::atomic<size_t> m_nSum = 0;
+        };
+
+        MyPull puller;
+        assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+
+        Push<Dialer> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+
+        enum { ROUND_COUNT = 100 };
+        size_t nSum = 0;
+        for (uint32_t i(0); i < ROUND_COUNT; ++i) {
+            Msg m(0);
+            m.insert_string("Hello World! Sync!");
+            assert(pusher.async_send(MSG_CODE_SYNC, std::move(m)) == NNG_OK);
+            m = Msg(0);
+            m.insert_string("Hello World! Async!");
+            assert(pusher.async_send(MSG_CODE_ASYNC, std::move(m)) == NNG_OK);
+            m = Msg(0);
+            m.append_u32(i);
+            nSum += i;
+            assert(pusher.async_send(MSG_CODE_COUNT, std::move(m)) == NNG_OK);
+            assert(pusher.async_send(MSG_CODE_PLUGIN, Msg(0)) == NNG_OK);
+            assert(pusher.async_send(MSG_CODE_COUNT + 1, Msg(0)) == NNG_OK);
+        }
+
+        for (size_t i(0); i < 100 && puller.m_nCountUnknown < ROUND_COUNT; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(puller.m_nCountSync == ROUND_COUNT);
+        assert(puller.m_nCountAsync == ROUND_COUNT);
+        assert(puller.m_nCountPlugin == ROUND_COUNT);
+        assert(puller.m_nCountUnknown == ROUND_COUNT);
+        assert(puller.m_nSum == nSum);
+
+        pusher.close();
+        puller.stop_dispatch();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_MsgPool() {
+        using namespace nng;
+        enum {
+            MSG_CODE0 = 0x1,
+        };
+        class MyPull : public Service<Pull<Dialer>>
+        {
+        private:
+            virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override final {
+                assert(code == MSG_CODE0);
+                assert(msg.len() == 200);
+                m_nCount++;
+                return {};
+            }
+
+        public:
+            std::atomic<size_t> m_nCount = 0;
+        };
+
+        MsgPool::enable();
+        MsgPool::reset_stats();
+
+        // 取出的消息长度为请求的大小，正文和头部已清空
+        {
+            Msg m(200);
+            assert(m.len() == 200 && m.header_len() == 0);
+            m.header_append_u32(1);
+        }
+        {
+            Msg m(100);
+            assert(m.len() == 100 && m.header_len() == 0);
+        }
+
+        // 反复构造和销毁同等级的消息时命中回收池
+        for (size_t i(0); i < 1000; ++i) {
+            Msg m(200);
+            std::memset(m.body(), 0, m.len());
+        }
+        auto stats = MsgPool::stats();
+        assert(stats._Hits >= 1000);
+        assert(stats._Misses <= 2);
+
+        // 分发循环中销毁的接收消息归还回收池
+        MyPull puller;
+        assert(puller.start_dispatch(m_szAddr) == NNG_OK);
+
+        Push<Dialer> pusher;
+        assert(pusher.start(m_szAddr) == NNG_OK);
+
+        enum { MSG_COUNT = 1000 };
+        for (size_t i(0); i < MSG_COUNT; ++i) {
+            Msg m(200);
+            assert(pusher.async_send(MSG_CODE0, std::move(m)) == NNG_OK);
+        }
+        for (size_t i(0); i < 100 && puller.m_nCount < MSG_COUNT; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(puller.m_nCount == MSG_COUNT);
+        assert(MsgPool::stats()._Recycled > stats._Recycled);
+
+        pusher.close();
+        puller.stop_dispatch();
+
+        MsgPool::enable(false);
+        MsgPool::trim();
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_MsgReader() {
+        using namespace nng;
+
+        Msg m(0);
+        m.insert_string("Front");
+        m.insert_u16(0x1234);
+        m.append_u32(0x89ABCDEF);
+        m.append_u64(0x0123456789ABCDEFull);
+        m.append_string("Back");
+        m.append_u32(0xFEEDFACE);
+        size_t nLen = m.len();
+
+        MsgReader reader(m);
+        uint16_t u16 = 0;
+        uint32_t u32 = 0;
+        uint64_t u64 = 0;
+        std::string_view sv;
+        std::span<const std::byte> bytes;
+
+        // 从开头读取，格式与 Msg::trim_* 一致
+        assert(reader.trim_u16(&u16) == NNG_OK && u16 == 0x1234);
+        assert(reader.trim_string(&sv) == NNG_OK && sv == "Front");
+        assert(sv.data() >= (const char*)m.body() && sv.data() < (const char*)m.body() + m.len());
+        assert(reader.trim_u32(&u32) == NNG_OK && u32 == 0x89ABCDEF);
+
+        // 从末尾读取，格式与 Msg::chop_* 一致
+        assert(reader.chop_u32(&u32) == NNG_OK && u32 == 0xFEEDFACE);
+        assert(reader.chop_string(&sv) == NNG_OK && sv == "Back");
+        assert(reader.remaining() == sizeof(uint64_t));
+        assert(reader.rest().size() == sizeof(uint64_t));
+        assert(reader.chop_u64(&u64) == NNG_OK && u64 == 0x0123456789ABCDEFull);
+        assert(reader.empty());
+
+        // 长度不足时返回错误且游标不动
+        assert(reader.trim_u16(&u16) == NNG_EINVAL);
+        assert(reader.chop_bytes(1, &bytes) == NNG_EINVAL);
+        MsgReader reader2(m);
+        assert(reader2.skip(sizeof(uint16_t)) == NNG_OK);
+        assert(reader2.chop_string(&sv) == NNG_EINVAL);
+        assert(reader2.remaining() == nLen - sizeof(uint16_t));
+        assert(reader2.trim_bytes(4, &bytes) == NNG_OK && bytes.size() == 4);
+        assert(reader2.trim_string(&sv) == NNG_EINVAL);
+
+        // 消息本身未被修改
+        assert(m.len() == nLen);
+        assert(m.trim_u16() == 0x1234);
+        assert(m.trim_string() == "Front");
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_MsgWriter() {
+        using namespace nng;
+
+        // 按预计大小一次扩展，原地写入
+        Msg m;
+        {
+            MsgWriter writer(m, sizeof(uint16_t) + MsgWriter::string_size("Front") + sizeof(uint64_t) + MsgWriter::string_size("Back") + 8);
+            assert(writer.write_u16(0x1234) == NNG_OK);
+            assert(writer.write_prefixed_string("Front") == NNG_OK);
+            assert(writer.write_u64(0x0123456789ABCDEFull) == NNG_OK);
+            assert(writer.write_suffixed_string("Back") == NNG_OK);
+            assert(writer.remaining() == 8);
+        }
+        // 未写满的部分已裁掉
+        assert(m.len() == sizeof(uint16_t) + 9 + sizeof(uint64_t) + 8);
+
+        // 格式与 MsgReader 和 Msg::trim_* / chop_* 一致
+        MsgReader reader(m);
+        uint16_t u16 = 0;
+        uint64_t u64 = 0;
+        std::string_view sv;
+        assert(reader.trim_u16(&u16) == NNG_OK && u16 == 0x1234);
+        assert(reader.trim_string(&sv) == NNG_OK && sv == "Front");
+        assert(reader.chop_string(&sv) == NNG_OK && sv == "Back");
+        assert(reader.chop_u64(&u64) == NNG_OK && u64 == 0x0123456789ABCDEFull);
+        assert(reader.empty());
+        assert(m.chop_string() == "Back");
+        assert(m.chop_u64() == 0x0123456789ABCDEFull);
+        assert(m.trim_u16() == 0x1234);
+        assert(m.trim_string() == "Front");
+        assert(m.len() == 0);
+
+        // 超出预计大小时返回错误，已写入的内容不变
+        {
+            MsgWriter writer(m, sizeof(uint32_t));
+            assert(writer.write_u64(1) == NNG_EINVAL);
+            assert(writer.write_prefixed_string("") == NNG_OK);
+            assert(writer.write_u16(1) == NNG_EINVAL);
+            writer.finish();
+            assert(writer.write_bytes("", 0) == NNG_OK);
+        }
+        assert(m.len() == sizeof(uint32_t) && m.trim_string().empty());
+
+        // 追加到已有正文之后，按字段自动计算大小
+        Msg m2(0);
+        m2.append_u32(0xFEEDFACE);
+        assert(MsgWriter::append(m2, (uint16_t)0xABCD, std::string("Hello"), (uint32_t)0x89ABCDEF, "World") == NNG_OK);
+        assert(m2.len() == sizeof(uint32_t) + sizeof(uint16_t) + 9 + sizeof(uint32_t) + 9);
+        assert(m2.trim_u32() == 0xFEEDFACE);
+        assert(m2.trim_u16() == 0xABCD);
+        assert(m2.trim_string() == "Hello");
+        assert(m2.trim_u32() == 0x89ABCDEF);
+        assert(m2.trim_string() == "World");
+        assert(m2.len() == 0);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_Pod() {
+        using namespace nng;
+
+        // 可平凡复制的结构体按本机内存表示整体复制
+        Msg m(0);
+        assert(m.append_pod(POD_PLAIN{ 0x01020304, 0x0506 }) == NNG_OK);
+        assert(m.len() == sizeof(POD_PLAIN));
+        POD_PLAIN plain = m.chop_pod<POD_PLAIN>();
+        assert(plain._X == 0x01020304 && plain._Y == 0x0506 && m.len() == 0);
+
+        // 有 Schema 的结构体紧凑编码，FO_NETWORK 字段与 append_u* / trim_u* 的格式一致
+        POD_ORDER order{ 0x0123456789ABCDEFull, { 0x89ABCDEF, 7 }, { 0x1122, 0x3344 }, { 'a', 'b', 'c', 'd' }, 0xFEEDFACE };
+        static_assert(Pod<POD_ORDER>::size == 8 + 5 + 4 + 4 + 4);
+        assert(m.append_pod(order) == NNG_OK);
+        assert(m.len() == Pod<POD_ORDER>::size);
+        assert(m.trim_u64() == 0x0123456789ABCDEFull);
+        assert(m.trim_u32() == 0x89ABCDEF);
+        m.realloc(0);
+
+        // 追加、插入后从两端整体裁剪，不需要按相反顺序逐个字段读取
+        assert(m.append_u32(0x55AA55AA) == NNG_OK);
+        assert(m.append_pod(order) == NNG_OK);
+        assert(m.insert_pod(order) == NNG_OK);
+        POD_ORDER back = m.chop_pod<POD_ORDER>();
+        POD_ORDER front{};
+        assert(m.trim_pod(&front) == NNG_OK);
+        for (auto& o : { back, front }) {
+            assert(o._Id == order._Id && o._Item._Price == order._Item._Price && o._Item._Qty == 7);
+            assert(o._Levels[1] == 0x3344 && std::memcmp(o._Tag, "abcd", 4) == 0 && o._Raw == 0xFEEDFACE);
+        }
+        assert(m.chop_pod(&front) == NNG_EINVAL);
+        assert(m.len() == sizeof(uint32_t) && m.trim_u32() == 0x55AA55AA);
+
+        // MsgWriter / MsgReader 使用相同的编码
+        {
+            MsgWriter writer(m, Pod<POD_ORDER>::size + Pod<POD_PLAIN>::size);
+            assert(writer.write_pod(order) == NNG_OK);
+            assert(writer.write_pod(POD_PLAIN{ 1, 2 }) == NNG_OK);
+            assert(writer.write_pod(POD_PLAIN{ 1, 2 }) == NNG_EINVAL);
+        }
+        MsgReader reader(m);
+        assert(reader.chop_pod(&plain) == NNG_OK && plain._X == 1 && plain._Y == 2);
+        assert(reader.trim_pod(&front) == NNG_OK && front._Id == order._Id && front._Raw == order._Raw);
+        assert(reader.empty() && reader.trim_pod(&front) == NNG_EINVAL);
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
+
+    static void TestMessage_Array() {
+        using namespace nng;
+
+        // 长度不是 SIMD 块大小的整数倍，覆盖逐个转换的尾部
+        std::vector<uint16_t> v16(1003);
+        std::vector<uint32_t> v32(1001);
+        std::vector<uint64_t> v64(999);
+        for (size_t i = 0; i < v64.size(); ++i) {
+            v16[i] = (uint16_t)(i * 0x0101 + 1);
+            v32[i] = (uint32_t)(i * 0x01020304 + 5);
+            v64[i] = i * 0x0102030405060708ull + 9;
+        }
+        for (size_t i = v64.size(); i < v16.size(); ++i) {
+            v16[i] = (uint16_t)i;
+            if (i < v32.size()) {
+                v32[i] = (uint32_t)i;
+            }
+        }
+
+        // 网络字节序与逐个 append_u* / trim_u* 的格式一致
+        Msg m(0);
+        assert(m.append_array<uint32_t>(v32) == NNG_OK);
+        assert(m.len() == v32.size() * sizeof(uint32_t));
+        for (size_t i = 0; i < 3; ++i) {
+            assert(m.trim_u32() == v32[i]);
+        }
+        assert(m.append_u64(v64[0]) == NNG_OK);
+        std::vector<uint32_t> r32(v32.size() - 3);
+        assert(m.trim_array<uint32_t>(r32) == NNG_OK);
+        assert(std::equal(r32.begin(), r32.end(), v32.begin() + 3));
+        assert(m.trim_u64() == v64[0] && m.len() == 0);
+
+        // 从末尾裁剪，数组整体读取，元素顺序不变
+        assert(m.append_array<uint16_t>(v16) == NNG_OK);
+        assert(m.append_array<uint64_t>(v64) == NNG_OK);
+        std::vector<uint64_t> r64(v64.size());
+        std::vector<uint16_t> r16(v16.size());
+        assert(m.chop_array<uint64_t>(r64) == NNG_OK && r64 == v64);
+        assert(m.chop_array<uint16_t>(r16) == NNG_OK && r16 == v16);
+        assert(m.len() == 0 && m.chop_array<uint16_t>(r16) == NNG_EINVAL);
+
+        // 本机字节序只做复制
+        assert(m.append_array<uint32_t>(v32, FO_NATIVE) == NNG_OK);
+        assert(std::memcmp(m.body(), v32.data(), m.len()) == 0);
+
+        // MsgWriter / MsgReader 使用相同的编码
+        m.realloc(0);
+        {
+            MsgWriter writer(m, sizeof(uint32_t) + v64.size() * sizeof(uint64_t));
+            assert(writer.write_u32((uint32_t)v64.size()) == NNG_OK);
+            assert(writer.write_array<uint64_t>(v64) == NNG_OK);
+            assert(writer.write_array<uint64_t>(v64) == NNG_EINVAL);
+        }
+        MsgReader reader(m);
+        uint32_t count = 0;
+        assert(reader.trim_u32(&count) == NNG_OK && count == v64.size());
+        std::fill(r64.begin(), r64.end(), 0);
+        assert(reader.trim_array<uint64_t>(r64) == NNG_OK && r64 == v64 && reader.empty());
+        printf("%s -> Passed\r\n", __FUNCTION__);
+    }
 
     static void TestRawMessage_PushPull_HugeMessage_ServiceAio() {
         using namespace nng;
@@ -1403,6 +3271,31 @@ int main()
     NngTester::TestMessage_Pair_ServiceAio();
     NngTester::TestRawMessage_PushPull_HugeMessage_ServiceAio();
     NngTester::TestMessage_RequestResponse_ServiceAio();
+    NngTester::TestMessage_RequestParallel();
+    NngTester::TestRawMessage_PushPull_LockFree();
+    NngTester::TestRawMessage_PushPull_QueueLimit();
+    NngTester::TestRawMessage_PushPull_Batch();
+    NngTester::TestRawMessage_PushPull_SendParallel();
+    NngTester::TestMessage_RequestCallback();
+    NngTester::TestMessage_Coroutine();
+    NngTester::TestMessage_RequestDeadline();
+    NngTester::TestRawMessage_PushPull_Priority();
+    NngTester::TestRawMessage_PushPull_Coalesce();
+    NngTester::TestRawMessage_PushPull_DispatchTimeout();
+    NngTester::TestMessage_RequestResponse_ServiceThreads();
+    NngTester::TestMessage_RequestResponse_ServiceAioParallel();
+    NngTester::TestMessage_ContextParallel();
+    NngTester::TestMessage_ResponseParallel_DeferReply();
+    NngTester::TestMessage_ResponseParallel_Autoscale();
+    NngTester::TestMessage_Executor();
+    NngTester::TestRawMessage_PushPull_KeyOrdered();
+    NngTester::TestRawMessage_PushPull_BatchDispatch();
+    NngTester::TestRawMessage_PushPull_Router();
+    NngTester::TestMessage_MsgPool();
+    NngTester::TestMessage_MsgReader();
+    NngTester::TestMessage_MsgWriter();
+    NngTester::TestMessage_Pod();
+    NngTester::TestMessage_Array();
     nng::util::uninitialize();
     return EXIT_SUCCESS;
 }
\ No newline at end of file
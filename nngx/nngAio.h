@@ -149,6 +149,21 @@ namespace nng
             nng_aio_wait(_My_aio);
         }
 
+        // 停止异步 I/O 操作
+        // 说明：中止当前操作并等待回调执行完毕，之后在该 aio 上发起的操作会立即失败
+        void stop() noexcept {
+            nng_aio_stop(_My_aio);
+        }
+
+        // 延迟释放异步 I/O 资源
+        // 说明：由 nng 的回收线程停止并释放 aio，可以在该 aio 自身的回调中调用；调用后当前对象为空
+        void reap() noexcept {
+            if (_My_aio) {
+                nng_aio_reap(_My_aio);
+                _My_aio = nullptr;
+            }
+        }
+
         // 执行异步睡眠操作
         // 参数：ms - 睡眠时间（毫秒）
         void sleep(nng_duration ms) noexcept {
@@ -1,8 +1,20 @@
 #pragma once
 
+#include <deque>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include <ranges>
+#include <utility>
+#include <condition_variable>
+
 #include "nngException.h"
 #include "nngMsg.h"
 #include "nngSocket.h"
+#include "nngCtx.h"
+#include "nngQueue.h"
+#include "nngInplaceFunction.h"
+#include "nngTimerWheel.h"
 
 namespace nng
 {
@@ -47,35 +59,490 @@ namespace nng
     // AsyncSender 类：异步发送基类，继承 AsyncContext，提供消息队列和回调处理
     // 用途：支持异步消息发送，管理消息队列并处理发送/接收回调
     // 特性：
-    // - 使用消息队列（std::queue）管理待发送消息
+    // - 使用消息队列（std::deque）管理待发送消息，或通过 set_lock_free 改用无锁环形队列
+    // - 支持通过 set_queue_limit 限制排队的消息数/字节数，并选择队列满时的背压策略
+    // - 支持单个消息的截止时间（在途消息使用 aio 超时，排队消息使用时间轮）以及通过句柄取消
+    // - 支持优先级通道：控制类消息不必排在大量批量消息之后，通道之间可严格优先或加权轮转
+    // - 支持小消息合并发送（Nagle 式），由接收方的 DispatcherNoReturn 拆分
     // - 提供虚函数接口以支持子类自定义发送/接收行为
     // - 线程安全，通过 AsyncContext 的互斥锁保护
     class AsyncSender : public AsyncContext
     {
+    public:
+        // 回复回调：在 aio 回调中以 (错误码, 回复消息) 调用，错误码非 NNG_OK 时回复消息为空
+        using _Ty_reply_callback = InplaceFunction<void(nng_err, Msg&&)>;
+        // 发送句柄：标识一次带截止时间或可取消的发送，用于 cancel
+        typedef uint64_t _Ty_send_handle;
+
+        // 发送优先级：每个优先级对应一个独立的排队通道
+        enum class PRIORITY : uint8_t
+        {
+            HIGH,       // 控制类消息（取消、心跳等）
+            NORMAL      // 普通/批量消息，未指定优先级时使用
+        };
+        static constexpr size_t _PRIORITY_COUNT = 2;
+
     protected:
         typedef struct _MSG_ITEM
         {
             Msg _Msg;
             std::optional<std::promise<Msg>> _Promise_reply;
+            _Ty_reply_callback _Callback_reply;
+            size_t _Bytes = 0;  // 入队时的消息正文长度，用于队列字节数统计
+            nng_time _Deadline = 0;     // 绝对截止时间，0 表示不限制
+            _Ty_send_handle _Id = 0;    // 发送句柄，0 表示不可取消
+            bool _Dead = false;         // 已在队列中被取消/过期/丢弃，出队时直接移除
+            PRIORITY _Priority = PRIORITY::NORMAL;
+
+            // 检查消息项是否需要接收回复
+            // 返回：true 表示带有回复承诺或回复回调
+            bool _Want_reply() const noexcept {
+                return _Promise_reply || _Callback_reply;
+            }
         } MSG_ITEM, * PMSG_ITEM;
 
+        typedef struct _SEND_SLOT
+        {
+            enum
+            {
+                SSS_IDLE,
+                SSS_SEND,
+                SSS_RECV
+            } _State = SSS_IDLE;
+            Aio _Aio;
+            std::optional<Ctx> _Ctx;
+            MSG_ITEM _Msg_item;
+            void* _Owner;
+
+            // 发送槽构造函数
+            // 参数：callback - 回调函数，owner - 父对象
+            // 异常：若 Aio 创建失败，抛出 Exception
+            explicit _SEND_SLOT(void (*callback)(void*), void* owner) noexcept(false)
+                : _Aio(callback, this), _Owner(owner) {
+            }
+        } SEND_SLOT, * PSEND_SLOT;
+
+        typedef struct _TIMER
+        {
+            Aio _Aio;                               // 时间轮推进使用的睡眠 aio
+            TimerWheel<_Ty_send_handle> _Wheel;
+            bool _Running = false;                  // 睡眠 aio 是否在途
+
+            // 定时器构造函数
+            // 参数：callback - 回调函数，owner - 父对象
+            // 异常：若 Aio 创建或时间轮分配失败，抛出 Exception 或 std::bad_alloc
+            explicit _TIMER(void (*callback)(void*), void* owner) noexcept(false)
+                : _Aio(callback, owner) {
+            }
+        } TIMER, * PTIMER;
+
     public:
+        // 发送队列满时的处理策略
+        enum QUEUE_POLICY
+        {
+            QP_BLOCK,           // 阻塞调用方，直到队列有空位或等待超时
+            QP_FAIL,            // 立即失败，返回 NNG_EAGAIN
+            QP_DROP_OLDEST,     // 丢弃队列中最早的待发送消息，接收新消息
+            QP_DROP_NEWEST      // 丢弃新消息，返回 NNG_OK
+        };
+
+        // 优先级通道之间的调度策略
+        enum LANE_POLICY
+        {
+            LP_STRICT,          // 严格优先：只要高优先级通道有消息就先发送
+            LP_WEIGHTED         // 加权轮转：各通道按权重比例交替发送，低优先级不会饿死
+        };
+
         // 构造函数：初始化异步发送器
         // 异常：若 Aio 分配失败，抛出 Exception
         AsyncSender() noexcept(false) : AsyncContext(_Callback_sender, this) {}
 
-        // 析构函数：释放异步发送器资源
-        virtual ~AsyncSender() noexcept = default;
+        // 析构函数：停止所有在途的 aio，再释放队列等资源
+        virtual ~AsyncSender() noexcept {
+            _My_stopping.store(true);
+            {
+                // 与等待方在锁内检查 _My_stopping 相对应，保证不会错过唤醒
+                _Ty_scoped_lock locker(_My_mtx);
+            }
+            _My_queue_cv.notify_all();
+            if (_My_timer) {
+                _My_timer->_Aio.stop();
+            }
+            for (auto& _Slot : _My_slots) {
+                _Slot->_Aio.stop();
+            }
+            Aio::stop();
+        }
+
+        // 开启无锁提交模式
+        // 参数：capacity - 无锁环形队列的容量（向上取整为 2 的幂）
+        // 返回：操作结果，0 表示成功；NNG_EBUSY 表示已开启、已使用发送槽或已有消息在途
+        // 说明：须在首次发送之前调用；开启后提交只需一次 CAS，aio 回调无锁出队；
+        //       设置了队列上限且为 QP_BLOCK 策略时，队列满的提交方阻塞等待空位，不占用 CPU
+        int set_lock_free(size_t capacity) noexcept {
+            _Ty_scoped_lock locker(_My_mtx);
+            if (capacity == 0) {
+                return NNG_EINVAL;
+            }
+            if (_My_ring || !_My_slots.empty() || !_Lanes_empty() || (_My_aio_state != INIT && _My_aio_state != IDLE)) {
+                return NNG_EBUSY;
+            }
+
+            try {
+                _My_ring = std::make_unique<MpscQueue<MSG_ITEM>>(capacity);
+            }
+            catch (const std::bad_alloc&) {
+                return NNG_ENOMEM;
+            }
+
+            return NNG_OK;
+        }
+
+        // 设置发送队列上限（背压）
+        // 参数：max_msgs - 最多排队的消息数，0 表示不限制
+        //       max_bytes - 最多排队的消息正文字节数，0 表示不限制
+        //       policy - 队列满时的处理策略
+        //       block_timeout - QP_BLOCK 策略下的最长等待时间（毫秒），NNG_DURATION_INFINITE 表示一直等待
+        // 说明：
+        // - 队列为空时总是接收一条消息，即使其长度超过 max_bytes
+        // - 被拒绝或被丢弃的消息若带有回复承诺，承诺以 Exception 结束（NNG_EAGAIN / NNG_ECANCELED / NNG_ETIMEDOUT）
+        // - QP_BLOCK 会在持有发送器互斥锁的情况下等待，不可在发送器的回调中使用
+        // - 无锁模式下队列容量同时受环形队列容量限制，QP_DROP_OLDEST 退化为 QP_DROP_NEWEST
+        void set_queue_limit(size_t max_msgs, size_t max_bytes, QUEUE_POLICY policy = QP_BLOCK,
+            nng_duration block_timeout = NNG_DURATION_INFINITE) noexcept {
+            _Ty_scoped_lock locker(_My_mtx);
+            _My_limit_msgs = max_msgs;
+            _My_limit_bytes = max_bytes;
+            _My_limit_policy = policy;
+            _My_limit_timeout = block_timeout;
+            _My_queue_cv.notify_all();
+        }
+
+        // 获取发送队列中的消息数
+        // 返回：排队中尚未发送完成的消息数（单 aio 模式下包含正在发送的一条），生产者可据此自行限流
+        size_t queue_depth() const noexcept {
+            return _My_queue_depth.load(std::memory_order_relaxed);
+        }
+
+        // 获取发送队列中的消息字节数
+        // 返回：排队中消息正文长度之和
+        size_t queue_bytes() const noexcept {
+            return _My_queue_bytes.load(std::memory_order_relaxed);
+        }
+
+        // 获取因队列满而被丢弃的消息数
+        // 返回：QP_DROP_OLDEST / QP_DROP_NEWEST 策略下累计丢弃的消息数
+        size_t queue_dropped() const noexcept {
+            return _My_queue_dropped.load(std::memory_order_relaxed);
+        }
+
+        // 设置优先级通道之间的调度策略
+        // 参数：policy - 调度策略（默认 LP_STRICT），high_weight / normal_weight - LP_WEIGHTED 策略下各通道的权重
+        // 说明：
+        // - 采用平滑加权轮转，如权重 4:1 时每发送 4 条高优先级消息至少发送 1 条普通消息
+        // - 消息一旦交给 aio 便不可抢占，高优先级消息最多等待当前在途的消息发送完成
+        // - 无锁模式只有一个环形队列，忽略优先级
+        void set_priority_policy(LANE_POLICY policy, unsigned high_weight = 4, unsigned normal_weight = 1) noexcept {
+            _Ty_scoped_lock locker(_My_mtx);
+            _My_lane_policy = policy;
+            _My_lane_weight[(size_t)PRIORITY::HIGH] = (std::max)(high_weight, 1u);
+            _My_lane_weight[(size_t)PRIORITY::NORMAL] = (std::max)(normal_weight, 1u);
+            for (auto& _Current : _My_lane_current) {
+                _Current = 0;
+            }
+        }
+
+        // 取消一次发送
+        // 参数：handle - 发送时获得的句柄
+        // 返回：操作结果，0 表示已取消（回复以 NNG_ECANCELED 结束）；NNG_ENOENT 表示已完成、不存在或句柄为 0；
+        //       NNG_ENOTSUP 表示无锁模式下该消息不在途（尚在环形队列中或已完成）
+        // 说明：排队中的消息立即以 NNG_ECANCELED 结束；在途的消息中止其 aio，由 aio 回调结束
+        int cancel(_Ty_send_handle handle) noexcept {
+            if (handle == 0) {
+                return NNG_ENOENT;
+            }
+            _Ty_scoped_lock locker(_My_mtx);
+            if (_My_ring) {
+                return _Ring_abort(handle, NNG_ECANCELED);
+            }
+            return _Abort_item(handle, NNG_ECANCELED);
+        }
 
     protected:
+        // 创建并行发送槽
+        // 参数：parallel - 发送槽数量，use_ctx - 每个槽是否使用独立的 Ctx
+        // 返回：操作结果，0 表示成功
+        // 说明：须在套接字创建之后、首次发送之前调用；创建后所有发送都经由发送槽完成
+        int _Create_slots(size_t parallel, bool use_ctx) noexcept {
+            _Ty_scoped_lock locker(_My_mtx);
+            if (parallel == 0) {
+                return NNG_EINVAL;
+            }
+            if (_My_ring || !_My_slots.empty() || !_Lanes_empty() || (_My_aio_state != INIT && _My_aio_state != IDLE)) {
+                return NNG_EBUSY;
+            }
+
+            try {
+                std::vector<std::unique_ptr<SEND_SLOT>> _Slots;
+                _Slots.reserve(parallel);
+                for (size_t i = 0; i < parallel; ++i) {
+                    auto _Slot = std::make_unique<SEND_SLOT>(_Callback_slot, this);
+                    if (use_ctx) {
+                        _Slot->_Ctx.emplace(*this);
+                    }
+                    _Slots.push_back(std::move(_Slot));
+                }
+
+                _My_slots = std::move(_Slots);
+            }
+            catch (const Exception& e) {
+                return e.get_error();
+            }
+            catch (const std::bad_alloc&) {
+                return NNG_ENOMEM;
+            }
+
+            _My_idle_slots.reserve(_My_slots.size());
+            for (auto& _Slot : _My_slots) {
+                _My_idle_slots.push_back(_Slot.get());
+            }
+
+            return NNG_OK;
+        }
+
         // 发送消息项
         // 参数：_Msg_item - 包含消息和可选回复承诺的消息项
-        void _Send(MSG_ITEM&& _Msg_item) noexcept {
+        // 返回：操作结果，0 表示成功（或按 QP_DROP_* 策略被丢弃）；队列满时按策略返回 NNG_EAGAIN / NNG_ETIMEDOUT / NNG_ECLOSED
+        int _Send(MSG_ITEM&& _Msg_item) noexcept {
+            if (_My_ring) {
+                int rv = _Ring_push(std::move(_Msg_item));
+                _Ring_kick();
+                return rv;
+            }
+
+            _Ty_unique_lock locker(_My_mtx);
+            int rv = _Enqueue(locker, std::move(_Msg_item));
+            _Kick();
+            return rv;
+        }
+
+        // 发送带截止时间、可取消的消息项
+        // 参数：_Msg_item - 消息项，timeout - 相对超时（毫秒），小于 0 表示不限制；handle - 可选，接收发送句柄
+        // 返回：操作结果，同 _Send
+        // 说明：句柄在提交前写入，回复可能先于本函数返回而完成
+        int _Send(MSG_ITEM&& _Msg_item, nng_duration timeout, _Ty_send_handle* handle) noexcept {
+            _Msg_item._Id = _My_next_id.fetch_add(1, std::memory_order_relaxed);
+            if (handle) {
+                *handle = _Msg_item._Id;
+            }
+            if (timeout >= 0) {
+                _Msg_item._Deadline = nng_clock() + timeout;
+            }
+            return _Send(std::move(_Msg_item));
+        }
+
+        // 批量发送消息项：整批只加锁一次（无锁模式下批量抢占环形队列位置），最后只触发一次发送
+        // 参数：_First, _Last - 源元素范围，_Make - 将源元素转换为 MSG_ITEM 的函数
+        // 返回：操作结果，0 表示全部提交成功；否则为第一条被拒绝消息的错误码，其后的元素不再提交
+        template <typename _Iter_t, typename _Sent_t, typename _Make_t>
+        int _Send_batch(_Iter_t _First, _Sent_t _Last, _Make_t&& _Make) noexcept {
+            int rv = NNG_OK;
+            if (_My_ring) {
+                while (_First != _Last) {
+                    // 未设置队列上限时整段抢占，否则逐条按策略入队
+                    size_t _Count = 0;
+                    if (_My_limit_msgs == 0 && _My_limit_bytes == 0) {
+                        _Count = _My_ring->try_push_bulk((size_t)std::ranges::distance(_First, _Last),
+                            [this, &_First, &_Make] {
+                                MSG_ITEM _Msg_item = _Make(*_First);
+                                ++_First;
+                                _Msg_item._Bytes = _Msg_item._Msg ? _Msg_item._Msg.len() : 0;
+                                _My_queue_depth.fetch_add(1, std::memory_order_relaxed);
+                                _My_queue_bytes.fetch_add(_Msg_item._Bytes, std::memory_order_relaxed);
+                                return _Msg_item;
+                            });
+                    }
+                    if (_Count == 0) {
+                        rv = _Ring_push(_Make(*_First));
+                        ++_First;
+                        if (rv != NNG_OK) {
+                            break;
+                        }
+                    }
+                }
+                _Ring_kick();
+                return rv;
+            }
+
+            _Ty_unique_lock locker(_My_mtx);
+            for (; _First != _Last; ++_First) {
+                rv = _Enqueue(locker, _Make(*_First));
+                if (rv != NNG_OK) {
+                    break;
+                }
+            }
+            _Kick();
+            return rv;
+        }
+
+        // 消息项入队：优先交给空闲的发送槽，否则放入队列；队列满时按策略处理（调用方持有锁）
+        // 参数：locker - 已持有的锁（QP_BLOCK 策略下等待时释放），_Msg_item - 消息项
+        // 返回：操作结果，同 _Send
+        int _Enqueue(_Ty_unique_lock& locker, MSG_ITEM&& _Msg_item) noexcept {
+            _Msg_item._Bytes = _Msg_item._Msg ? _Msg_item._Msg.len() : 0;
+            if (_My_idle_slots.empty() && _Queue_full(_Msg_item._Bytes)) {
+                switch (_My_limit_policy) {
+                case QP_BLOCK:
+                {
+                    // 等待前先发出已入队的消息，否则队列永远不会腾出空位
+                    _Kick();
+                    auto _Pred = [this, &_Msg_item] {
+                        return _My_stopping.load() || !_My_idle_slots.empty() || !_Queue_full(_Msg_item._Bytes);
+                    };
+                    if (_My_limit_timeout < 0) {
+                        _My_queue_cv.wait(locker, _Pred);
+                    }
+                    else if (!_My_queue_cv.wait_for(locker, std::chrono::milliseconds(_My_limit_timeout), _Pred)) {
+                        return _Queue_reject(_Msg_item, NNG_ETIMEDOUT);
+                    }
+                    if (_My_stopping.load()) {
+                        return _Queue_reject(_Msg_item, NNG_ECLOSED);
+                    }
+                    break;
+                }
+                case QP_DROP_OLDEST:
+                    while (_Queue_full(_Msg_item._Bytes) && _Queue_drop_oldest()) {}
+                    if (!_Queue_full(_Msg_item._Bytes)) {
+                        break;
+                    }
+                    [[fallthrough]];
+                case QP_DROP_NEWEST:
+                    _My_queue_dropped.fetch_add(1, std::memory_order_relaxed);
+                    _Queue_reject(_Msg_item, NNG_ECANCELED);
+                    return NNG_OK;
+                default:
+                    return _Queue_reject(_Msg_item, NNG_EAGAIN);
+                }
+            }
+
+            if (_My_idle_slots.empty()) {
+                _Queue_push(std::move(_Msg_item));
+            }
+            else {
+                PSEND_SLOT _Slot = _My_idle_slots.back();
+                _My_idle_slots.pop_back();
+                _Slot->_Msg_item = std::move(_Msg_item);
+                _Slot_send(*_Slot);
+            }
+            return NNG_OK;
+        }
+
+        // 设置小消息合并发送
+        // 参数：max_bytes - 合并消息的最大正文长度，0 表示关闭；linger - 数据不足一个合并消息时最多等待的时间（毫秒）
+        // 返回：操作结果，0 表示成功；NNG_ENOTSUP 表示已开启无锁模式或使用了发送槽
+        int _Set_coalesce(size_t max_bytes, nng_duration linger) noexcept {
             _Ty_scoped_lock locker(_My_mtx);
-            _My_msgs.push(std::move(_Msg_item));
+            if (_My_ring || !_My_slots.empty()) {
+                return NNG_ENOTSUP;
+            }
+            _My_coalesce_bytes = max_bytes;
+            _My_coalesce_linger = linger;
+            return NNG_OK;
+        }
+
+        // 单 aio 模式下，若 aio 空闲且队列非空，则发送下一条消息（调用方持有锁）
+        void _Kick() noexcept {
+            if (_My_slots.empty() && (_My_aio_state == INIT || _My_aio_state == IDLE)) {
+                if (_Coalesce_linger()) {
+                    return;
+                }
+                int _Lane = _Queue_select();
+                if (_Lane >= 0) {
+                    _Send_lane(_Lane);
+                }
+            }
+            else if (_My_aio_state == WAIT && (_My_queue_bytes.load(std::memory_order_relaxed) >= _My_coalesce_bytes ||
+                !_My_lanes[(size_t)PRIORITY::HIGH].empty())) {
+                // 已积攒够一个合并消息或有高优先级消息，提前结束等待
+                Aio::abort(NNG_ECANCELED);
+            }
+        }
+
+        // 单 aio 模式下发送指定通道的队首消息，在途期间受其截止时间约束（调用方持有锁）
+        // 参数：_Lane - 通道下标
+        void _Send_lane(int _Lane) noexcept {
+            _Queue_take(_Lane, _My_inflight);
+            if (_Coalescable(_My_inflight)) {
+                _Coalesce(_Lane);
+            }
+            _Set_expire(*this, _My_inflight);
+            AsyncContext::_Send(std::move(_My_inflight._Msg));
+        }
+
+        // 检查消息项能否合并发送：已开启合并、不需要回复、不可取消，且小于合并消息上限
+        // 参数：_Msg_item - 消息项
+        // 返回：true 表示可以合并
+        bool _Coalescable(const MSG_ITEM& _Msg_item) const noexcept {
+            return _My_coalesce_bytes != 0 && _Msg_item._Msg && !_Msg_item._Want_reply() && _Msg_item._Id == 0 &&
+                sizeof(uint32_t) + _Msg_item._Bytes + sizeof(Msg::_Ty_msg_code) < _My_coalesce_bytes;
+        }
+
+        // 将同一通道中紧随其后的小消息并入在途消息项（调用方持有锁）
+        // 参数：_Lane - 通道下标
+        // 说明：
+        // - 只有一条消息时原样发送，接收方无需拆分
+        // - 合并消息的空间一次预留，追加不会失败；预留失败时放弃合并
+        // - 被并入的消息项立即扣减队列统计，在途消息项仍按一条计入
+        void _Coalesce(int _Lane) noexcept {
+            auto& _Queue = _My_lanes[_Lane];
+            size_t _Total = sizeof(uint32_t) + _My_inflight._Bytes + sizeof(Msg::_Ty_msg_code);
+            Msg _Packed;
+            while (_Lane_ready(_Queue) && _Coalescable(_Queue.front()) &&
+                _Total + sizeof(uint32_t) + _Queue.front()._Bytes <= _My_coalesce_bytes) {
+                if (!_Packed) {
+                    if (_Packed.realloc(0) != NNG_OK || _Packed.reserve(_My_coalesce_bytes) != NNG_OK) {
+                        return;
+                    }
+                    Msg::_Pack_msg(_Packed, _My_inflight._Msg);
+                }
+
+                MSG_ITEM _Next;
+                _Queue_take(_Lane, _Next);
+                _Total += sizeof(uint32_t) + _Next._Bytes;
+                Msg::_Pack_msg(_Packed, _Next._Msg);
+                _Queue_release(_Next);
+            }
 
-            if (_My_aio_state == INIT || _My_aio_state == IDLE) {
-                AsyncContext::_Send(std::move(_My_msgs.front()._Msg));
+            if (_Packed) {
+                Msg::_Append_msg_code(_Packed, Msg::_MSG_CODE_PACKED);
+                _My_inflight._Msg = std::move(_Packed);
+            }
+        }
+
+        // 合并发送时，若队列中的数据不足一个合并消息，则先等待 linger 时间再发送（调用方持有锁）
+        // 返回：true 表示已开始等待，等待结束后由回调发送
+        // 说明：有高优先级消息排队时不等待
+        bool _Coalesce_linger() noexcept {
+            if (_My_coalesce_bytes == 0 || _My_coalesce_linger <= 0 || _My_stopping.load() ||
+                _My_queue_depth.load(std::memory_order_relaxed) == 0 ||
+                _My_queue_bytes.load(std::memory_order_relaxed) >= _My_coalesce_bytes ||
+                !_My_lanes[(size_t)PRIORITY::HIGH].empty()) {
+                return false;
+            }
+
+            _My_aio_state = WAIT;
+            Aio::sleep(_My_coalesce_linger);
+            return true;
+        }
+
+        // 按消息项的截止时间设置 aio 超时
+        // 参数：aio - 即将用于发送/接收的 aio，_Msg_item - 消息项
+        static void _Set_expire(nng_aio* aio, const MSG_ITEM& _Msg_item) noexcept {
+            if (_Msg_item._Deadline != 0) {
+                nng_aio_set_expire(aio, _Msg_item._Deadline);
+            }
+            else {
+                nng_aio_set_timeout(aio, NNG_DURATION_DEFAULT);
             }
         }
 
@@ -84,9 +551,19 @@ namespace nng
         // 参数：callback_context - 回调上下文（指向 AsyncSender）
         static void _Callback_sender(void* callback_context) noexcept {
             auto _Sender = reinterpret_cast<AsyncSender*>(callback_context);
+            if (_Sender->_My_ring) {
+                _Sender->_Ring_callback();
+                return;
+            }
+
             _Ty_scoped_lock locker(_Sender->_My_mtx);
-            assert(!_Sender->_My_msgs.empty());
-            auto& _Msg_item_ref = _Sender->_My_msgs.front();
+            if (_Sender->_My_aio_state == WAIT) {
+                // 合并等待结束，发送期间积攒的消息
+                _Sender->_Send_next();
+                return;
+            }
+
+            auto& _Msg_item_ref = _Sender->_My_inflight;
 
             nng_err e = _Sender->result();
             if (e == NNG_OK) {
@@ -94,7 +571,7 @@ namespace nng
                     _Sender->_On_sender_sent(_Msg_item_ref);
 
                     _Sender->release_msg();
-                    if (_Msg_item_ref._Promise_reply) {
+                    if (_Msg_item_ref._Want_reply()) {
                         _Sender->_My_aio_state = RECV;
                         _Sender->recv(*_Sender);
                         return;
@@ -103,30 +580,564 @@ namespace nng
                 else if (_Sender->_My_aio_state == RECV) {
                     Msg _Msg_reply = _Sender->release_msg();
                     _Sender->_On_sender_recv(_Msg_item_ref, _Msg_reply);
-                    _Msg_item_ref._Promise_reply->set_value(std::move(_Msg_reply));
+                    _Reply_complete(_Msg_item_ref, NNG_OK, std::move(_Msg_reply));
                 }
 
-                _Sender->_My_msgs.pop();
+                _Sender->_Queue_release(_Msg_item_ref);
+                _Msg_item_ref = MSG_ITEM();
                 _Sender->_Send_next();
             }
             else {
                 _Sender->_On_sender_exception(_Msg_item_ref, e);
 
+                // 以错误结束当前消息项，继续发送队列中的下一条，避免队列停滞
                 _Sender->release_msg();
-                _Sender->_My_aio_state = IDLE;
+                _Reply_complete(_Msg_item_ref, e, Msg());
+                _Sender->_Queue_release(_Msg_item_ref);
+                _Msg_item_ref = MSG_ITEM();
+                _Sender->_Send_next();
             }
         }
 
-        // 发送队列中的下一个消息
+        // 发送队列中的下一个消息，析构中不再发起
         void _Send_next() noexcept {
             _Ty_scoped_lock locker(_My_mtx);
 
-            if (_My_msgs.empty()) {
+            int _Lane = _My_stopping.load() ? -1 : _Queue_select();
+            if (_Lane >= 0) {
+                _Send_lane(_Lane);
+            }
+            else {
+                _My_aio_state = IDLE;
+            }
+        }
+
+        // 检查队列是否已达上限
+        // 参数：_Bytes - 待入队消息的正文长度
+        // 返回：true 表示再入队一条消息将超过消息数或字节数上限
+        bool _Queue_full(size_t _Bytes) const noexcept {
+            size_t _Depth = _My_queue_depth.load(std::memory_order_relaxed);
+            if (_My_limit_msgs != 0 && _Depth >= _My_limit_msgs) {
+                return true;
+            }
+            return _My_limit_bytes != 0 && _Depth != 0 &&
+                _My_queue_bytes.load(std::memory_order_relaxed) + _Bytes > _My_limit_bytes;
+        }
+
+        // 无锁模式：按上限预留队列中的一个位置，并发的生产者不会超出消息数或字节数上限
+        // 参数：_Bytes - 待入队消息的正文长度
+        // 返回：true 表示已预留（已计入 _My_queue_depth / _My_queue_bytes），false 表示队列已满
+        bool _Queue_reserve(size_t _Bytes) noexcept {
+            size_t _Depth = _My_queue_depth.load(std::memory_order_relaxed);
+            do {
+                if (_My_limit_msgs != 0 && _Depth >= _My_limit_msgs) {
+                    return false;
+                }
+            } while (!_My_queue_depth.compare_exchange_weak(_Depth, _Depth + 1, std::memory_order_relaxed));
+
+            if (_My_limit_bytes == 0) {
+                _My_queue_bytes.fetch_add(_Bytes, std::memory_order_relaxed);
+                return true;
+            }
+            // 与 _Queue_full 一致：队列为空时允许一条超出字节数上限的消息
+            size_t _Total = _My_queue_bytes.load(std::memory_order_relaxed);
+            do {
+                if (_Depth != 0 && _Total + _Bytes > _My_limit_bytes) {
+                    _My_queue_depth.fetch_sub(1, std::memory_order_relaxed);
+                    _Ring_notify_space();
+                    return false;
+                }
+            } while (!_My_queue_bytes.compare_exchange_weak(_Total, _Total + _Bytes, std::memory_order_relaxed));
+            return true;
+        }
+
+        // 消息项入队并累计队列统计（调用方持有锁）
+        // 参数：_Msg_item - 消息项
+        void _Queue_push(MSG_ITEM&& _Msg_item) noexcept {
+            _My_queue_depth.fetch_add(1, std::memory_order_relaxed);
+            _My_queue_bytes.fetch_add(_Msg_item._Bytes, std::memory_order_relaxed);
+            auto& _Lane = _My_lanes[(size_t)_Msg_item._Priority];
+            _Lane.push_back(std::move(_Msg_item));
+
+            // 可取消的消息项建立索引（std::deque 在两端增删时元素地址不变）
+            auto& _Back = _Lane.back();
+            if (_Back._Id != 0) {
+                try {
+                    _My_pending.emplace(_Back._Id, &_Back);
+                }
+                catch (const std::bad_alloc&) {
+                    // 无法建立索引时仍可依靠出队时的截止时间检查和在途 aio 超时
+                    return;
+                }
+                if (_Back._Deadline != 0) {
+                    _Timer_add(_Back._Id, _Back._Deadline);
+                }
+            }
+        }
+
+        // 取出指定通道的队首消息项（调用方持有锁）
+        // 参数：_Lane - 通道下标，_Msg_item - 接收取出的消息项
+        // 说明：不扣减队列统计，由调用方在合适的时机调用 _Queue_release（单 aio 模式下在途消息仍计入队列）
+        void _Queue_take(int _Lane, MSG_ITEM& _Msg_item) noexcept {
+            auto& _Front = _My_lanes[_Lane].front();
+            if (_Front._Id != 0) {
+                _My_pending.erase(_Front._Id);
+            }
+            _Msg_item = std::move(_Front);
+            _My_lanes[_Lane].pop_front();
+        }
+
+        // 扣减已取出消息项的队列统计，唤醒等待的生产者（调用方持有锁）
+        // 参数：_Msg_item - 已取出的消息项
+        void _Queue_release(const MSG_ITEM& _Msg_item) noexcept {
+            _My_queue_depth.fetch_sub(1, std::memory_order_relaxed);
+            _My_queue_bytes.fetch_sub(_Msg_item._Bytes, std::memory_order_relaxed);
+            _My_queue_cv.notify_all();
+        }
+
+        // 检查所有通道是否为空（含已失效、尚未移除的消息项）
+        // 返回：true 表示为空
+        bool _Lanes_empty() const noexcept {
+            for (auto& _Lane : _My_lanes) {
+                if (!_Lane.empty()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // 选择下一条要发送的消息所在的通道（调用方持有锁）
+        // 返回：通道下标，全部通道为空时返回 -1
+        // 说明：LP_WEIGHTED 策略采用平滑加权轮转，只在有消息的通道之间分配
+        int _Queue_select() noexcept {
+            int _Best = -1;
+            int _Total = 0;
+            for (int i = 0; i < (int)_PRIORITY_COUNT; ++i) {
+                if (!_Lane_ready(_My_lanes[i])) {
+                    continue;
+                }
+                if (_My_lane_policy == LP_STRICT) {
+                    return i;
+                }
+
+                _My_lane_current[i] += _My_lane_weight[i];
+                _Total += _My_lane_weight[i];
+                if (_Best < 0 || _My_lane_current[i] > _My_lane_current[_Best]) {
+                    _Best = i;
+                }
+            }
+
+            if (_Best >= 0) {
+                _My_lane_current[_Best] -= _Total;
+            }
+            return _Best;
+        }
+
+        // 移除通道队首已失效的消息项；队首消息已过截止时间时以 NNG_ETIMEDOUT 结束（调用方持有锁）
+        // 参数：_Lane - 通道
+        // 返回：true 表示队首是可以发送的消息项，false 表示通道为空
+        bool _Lane_ready(std::deque<MSG_ITEM>& _Lane) noexcept {
+            while (!_Lane.empty()) {
+                auto& _Front = _Lane.front();
+                if (!_Front._Dead && _Front._Deadline != 0 && _Front._Deadline <= nng_clock()) {
+                    _On_sender_exception(_Front, NNG_ETIMEDOUT);
+                    _Queue_kill(_Front, NNG_ETIMEDOUT);
+                }
+                if (!_Front._Dead) {
+                    return true;
+                }
+                _Lane.pop_front();
+            }
+            return false;
+        }
+
+        // 使排队中的消息项失效：以错误码结束其回复并扣减队列统计，出队时再移除（调用方持有锁）
+        // 参数：_Msg_item - 排队中（非在途）的消息项，e - 错误码
+        void _Queue_kill(MSG_ITEM& _Msg_item, nng_err e) noexcept {
+            _My_queue_depth.fetch_sub(1, std::memory_order_relaxed);
+            _My_queue_bytes.fetch_sub(_Msg_item._Bytes, std::memory_order_relaxed);
+            if (_Msg_item._Id != 0) {
+                _My_pending.erase(_Msg_item._Id);
+            }
+            _Msg_item._Dead = true;
+            _Msg_item._Msg = Msg();
+            _Reply_complete(_Msg_item, e, Msg());
+            _My_queue_cv.notify_all();
+        }
+
+        // 丢弃最早的一条待发送消息，从最低优先级的通道开始（调用方持有锁）
+        // 返回：true 表示已丢弃，false 表示没有可丢弃的消息
+        bool _Queue_drop_oldest() noexcept {
+            for (size_t i = _PRIORITY_COUNT; i-- > 0;) {
+                for (auto& _Item : _My_lanes[i]) {
+                    if (!_Item._Dead) {
+                        _My_queue_dropped.fetch_add(1, std::memory_order_relaxed);
+                        _Queue_kill(_Item, NNG_ECANCELED);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // 以错误码中止一次发送（调用方持有锁）
+        // 参数：handle - 发送句柄，e - 错误码
+        // 返回：操作结果，0 表示已中止；NNG_ENOENT 表示已完成、不存在或句柄为 0
+        // 说明：句柄 0 表示不可取消，不与未带句柄的在途消息匹配
+        int _Abort_item(_Ty_send_handle handle, nng_err e) noexcept {
+            if (handle == 0) {
+                return NNG_ENOENT;
+            }
+
+            auto _It = _My_pending.find(handle);
+            if (_It != _My_pending.end()) {
+                _On_sender_exception(*_It->second, e);
+                _Queue_kill(*_It->second, e);
+                return NNG_OK;
+            }
+
+            // 在途的消息：中止 aio，由回调结束
+            if (_My_slots.empty() && (_My_aio_state == SEND || _My_aio_state == RECV) && _My_inflight._Id == handle) {
+                Aio::abort(e);
+                return NNG_OK;
+            }
+            for (auto& _Slot : _My_slots) {
+                if (_Slot->_State != SEND_SLOT::SSS_IDLE && _Slot->_Msg_item._Id == handle) {
+                    _Slot->_Aio.abort(e);
+                    return NNG_OK;
+                }
+            }
+            return NNG_ENOENT;
+        }
+
+        // 为排队中的消息项添加截止时间定时器，必要时启动时间轮（调用方持有锁）
+        // 参数：handle - 发送句柄，deadline - 绝对截止时间
+        void _Timer_add(_Ty_send_handle handle, nng_time deadline) noexcept {
+            try {
+                if (!_My_timer) {
+                    _My_timer = std::make_unique<TIMER>(_Callback_timer, this);
+                }
+                _My_timer->_Wheel.add(deadline, handle);
+            }
+            catch (...) {
+                // 无法使用时间轮时仍可依靠出队时的截止时间检查和在途 aio 超时
+                return;
+            }
+
+            if (!_My_timer->_Running && !_My_stopping.load()) {
+                _My_timer->_Running = true;
+                _My_timer->_Aio.sleep(_My_timer->_Wheel.tick());
+            }
+        }
+
+        // 回调函数：时间轮推进，以 NNG_ETIMEDOUT 结束所有到期的消息项
+        // 参数：callback_context - 回调上下文（指向 AsyncSender）
+        static void _Callback_timer(void* callback_context) noexcept {
+            auto _Sender = static_cast<AsyncSender*>(callback_context);
+            _Ty_scoped_lock locker(_Sender->_My_mtx);
+            auto& _Timer = *_Sender->_My_timer;
+            if (_Sender->_My_stopping.load()) {
+                _Timer._Running = false;
+                return;
+            }
+
+            _Timer._Wheel.expire(nng_clock(), [_Sender](_Ty_send_handle handle) {
+                _Sender->_Abort_item(handle, NNG_ETIMEDOUT);
+            });
+
+            if (_Timer._Wheel.empty()) {
+                _Timer._Running = false;
+            }
+            else {
+                _Timer._Aio.sleep(_Timer._Wheel.tick());
+            }
+        }
+
+        // 拒绝消息项：若带有回复承诺或回复回调，则以错误码结束
+        // 参数：_Msg_item - 消息项，e - 错误码
+        // 返回：错误码 e
+        static int _Queue_reject(MSG_ITEM& _Msg_item, nng_err e) noexcept {
+            _Reply_complete(_Msg_item, e, Msg());
+            return e;
+        }
+
+        // 结束消息项的回复：调用回复回调，或设置回复承诺的值/异常；结束后不再重复通知
+        // 参数：_Msg_item - 消息项，e - 错误码，_Msg_reply - 回复消息（e 为 NNG_OK 时有效）
+        static void _Reply_complete(MSG_ITEM& _Msg_item, nng_err e, Msg&& _Msg_reply) noexcept {
+            if (_Msg_item._Callback_reply) {
+                auto _Callback = std::move(_Msg_item._Callback_reply);
+                _Callback(e, std::move(_Msg_reply));
+            }
+            else if (_Msg_item._Promise_reply) {
+                if (e == NNG_OK) {
+                    _Msg_item._Promise_reply->set_value(std::move(_Msg_reply));
+                }
+                else {
+                    _Msg_item._Promise_reply->set_exception(
+                        std::make_exception_ptr(Exception(e, "async_send")));
+                }
+                _Msg_item._Promise_reply.reset();
+            }
+        }
+
+        // 无锁模式：消息项入队，队列满时按策略处理（由调用方随后抢占发送权）
+        // 参数：_Msg_item - 消息项
+        // 返回：操作结果，同 _Send
+        int _Ring_push(MSG_ITEM&& _Msg_item) noexcept {
+            _Msg_item._Bytes = _Msg_item._Msg ? _Msg_item._Msg.len() : 0;
+            auto _Try_push = [this, &_Msg_item] {
+                if (!_Queue_reserve(_Msg_item._Bytes)) {
+                    return false;
+                }
+                size_t _Bytes = _Msg_item._Bytes;
+                if (_My_ring->try_push(std::move(_Msg_item))) {
+                    return true;
+                }
+                _My_queue_depth.fetch_sub(1, std::memory_order_relaxed);
+                _My_queue_bytes.fetch_sub(_Bytes, std::memory_order_relaxed);
+                _Ring_notify_space();
+                return false;
+            };
+
+            if (!_Try_push()) {
+                switch (_My_limit_policy) {
+                case QP_BLOCK:
+                {
+                    // 批量提交时之前入队的消息尚未触发发送，等待前先抢占一次发送权
+                    _Ring_kick();
+
+                    // 先登记等待者再检查队列，与 _Ring_notify_space 相对应；出队方腾出空位后唤醒
+                    _Ty_unique_lock locker(_My_mtx);
+                    _My_ring_waiters.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    bool _Pushed = false;
+                    auto _Pred = [this, &_Try_push, &_Pushed] {
+                        if (_My_stopping.load()) {
+                            return true;
+                        }
+                        _Pushed = _Try_push();
+                        return _Pushed;
+                    };
+                    if (_My_limit_timeout < 0) {
+                        _My_queue_cv.wait(locker, _Pred);
+                    }
+                    else {
+                        _My_queue_cv.wait_for(locker, std::chrono::milliseconds(_My_limit_timeout), _Pred);
+                    }
+                    _My_ring_waiters.fetch_sub(1);
+                    if (!_Pushed) {
+                        return _Queue_reject(_Msg_item, _My_stopping.load() ? NNG_ECLOSED : NNG_ETIMEDOUT);
+                    }
+                    break;
+                }
+                case QP_DROP_OLDEST:
+                case QP_DROP_NEWEST:
+                    _My_queue_dropped.fetch_add(1, std::memory_order_relaxed);
+                    _Queue_reject(_Msg_item, NNG_ECANCELED);
+                    return NNG_OK;
+                default:
+                    return _Queue_reject(_Msg_item, NNG_EAGAIN);
+                }
+            }
+
+            return NNG_OK;
+        }
+
+        // 无锁模式：队列腾出空位后唤醒 QP_BLOCK 策略下等待的生产者
+        // 说明：未设置队列上限时没有等待者，直接返回；与 _Ring_push 先登记等待者、再检查队列相对应，保证不会错过唤醒
+        void _Ring_notify_space() noexcept {
+            if (_My_limit_msgs == 0 && _My_limit_bytes == 0) {
+                return;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_My_ring_waiters.load(std::memory_order_relaxed) != 0) {
+                {
+                    _Ty_scoped_lock locker(_My_mtx);
+                }
+                _My_queue_cv.notify_all();
+            }
+        }
+
+        // 无锁模式：抢占发送权，抢到的一方负责出队并发送
+        // 说明：发送权（_My_ring_busy）同一时刻只有一个持有者，因此持有者是唯一的消费者
+        void _Ring_kick() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool _Expected = false;
+            if (_My_ring_busy.compare_exchange_strong(_Expected, true, std::memory_order_acquire)) {
+                _Ring_next();
+            }
+        }
+
+        // 无锁模式：发送权持有者取出下一个消息并发送，队列为空时释放发送权
+        void _Ring_next() noexcept {
+            for (;;) {
+                if (!_My_stopping.load(std::memory_order_relaxed) && _My_ring->try_pop(_My_inflight)) {
+                    _My_queue_depth.fetch_sub(1, std::memory_order_relaxed);
+                    _My_queue_bytes.fetch_sub(_My_inflight._Bytes, std::memory_order_relaxed);
+                    _Ring_notify_space();
+                    if (_My_inflight._Deadline != 0 && _My_inflight._Deadline <= nng_clock()) {
+                        // 无锁模式不使用时间轮，出队时检查截止时间
+                        _On_sender_exception(_My_inflight, NNG_ETIMEDOUT);
+                        _Reply_complete(_My_inflight, NNG_ETIMEDOUT, Msg());
+                        _My_inflight = MSG_ITEM();
+                        continue;
+                    }
+                    _Set_expire(*this, _My_inflight);
+                    if (_My_inflight._Id != 0) {
+                        // 可取消的消息：在锁内公开句柄并发起发送，cancel 看到句柄时 aio 已在途
+                        _Ty_scoped_lock locker(_My_mtx);
+                        _My_ring_handle = _My_inflight._Id;
+                        AsyncContext::_Send(std::move(_My_inflight._Msg));
+                        return;
+                    }
+                    AsyncContext::_Send(std::move(_My_inflight._Msg));
+                    return;
+                }
+
                 _My_aio_state = IDLE;
+                _My_ring_busy.store(false, std::memory_order_release);
+
+                // 释放发送权后再检查一次，避免与并发入队的生产者互相错过
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (_My_stopping.load(std::memory_order_relaxed) || _My_ring->empty()) {
+                    return;
+                }
+
+                bool _Expected = false;
+                if (!_My_ring_busy.compare_exchange_strong(_Expected, true, std::memory_order_acquire)) {
+                    return;
+                }
+            }
+        }
+
+        // 无锁模式：以错误码中止在途的可取消消息（调用方持有锁）
+        // 参数：handle - 发送句柄，e - 错误码
+        // 返回：操作结果，0 表示已中止；NNG_ENOTSUP 表示该消息不在途（尚在环形队列中或已完成）
+        int _Ring_abort(_Ty_send_handle handle, nng_err e) noexcept {
+            if (_My_ring_handle != handle) {
+                return NNG_ENOTSUP;
+            }
+            // aio 回调在锁内检查该错误码，发送完成与开始接收之间的中止也不会落空
+            _My_ring_abort = e;
+            Aio::abort(e);
+            return NNG_OK;
+        }
+
+        // 无锁模式：处理异步 I/O 操作的结果（调用方持有发送权；可取消的消息在锁内处理，与 cancel 互斥）
+        void _Ring_callback() noexcept {
+            auto& _Msg_item_ref = _My_inflight;
+
+            nng_err e = result();
+            std::unique_lock<_Ty_mutex> locker(_My_mtx, std::defer_lock);
+            if (_Msg_item_ref._Id != 0) {
+                locker.lock();
+                if (e == NNG_OK && _My_ring_abort != NNG_OK) {
+                    e = _My_ring_abort;
+                }
+            }
+
+            if (e == NNG_OK) {
+                if (_My_aio_state == SEND) {
+                    _On_sender_sent(_Msg_item_ref);
+
+                    release_msg();
+                    if (_Msg_item_ref._Want_reply()) {
+                        _My_aio_state = RECV;
+                        recv(*this);
+                        return;
+                    }
+                }
+                else if (_My_aio_state == RECV) {
+                    Msg _Msg_reply = release_msg();
+                    _On_sender_recv(_Msg_item_ref, _Msg_reply);
+                    _Reply_complete(_Msg_item_ref, NNG_OK, std::move(_Msg_reply));
+                }
+            }
+            else {
+                _On_sender_exception(_Msg_item_ref, e);
+
+                release_msg();
+                _Reply_complete(_Msg_item_ref, e, Msg());
+            }
+
+            if (locker.owns_lock()) {
+                _My_ring_handle = 0;
+                _My_ring_abort = NNG_OK;
+                locker.unlock();
+            }
+            _Msg_item_ref = MSG_ITEM();
+            _Ring_next();
+        }
+
+        // 回调函数：处理发送槽的异步 I/O 结果
+        // 参数：callback_context - 回调上下文（指向 SEND_SLOT）
+        static void _Callback_slot(void* callback_context) noexcept {
+            auto _Slot = static_cast<PSEND_SLOT>(callback_context);
+            auto _Sender = static_cast<AsyncSender*>(_Slot->_Owner);
+            _Ty_scoped_lock locker(_Sender->_My_mtx);
+            auto& _Msg_item_ref = _Slot->_Msg_item;
+
+            nng_err e = _Slot->_Aio.result();
+            if (e == NNG_OK) {
+                if (_Slot->_State == SEND_SLOT::SSS_SEND) {
+                    _Sender->_On_sender_sent(_Msg_item_ref);
+
+                    _Slot->_Aio.release_msg();
+                    if (_Msg_item_ref._Want_reply()) {
+                        _Slot->_State = SEND_SLOT::SSS_RECV;
+                        if (_Slot->_Ctx) {
+                            _Slot->_Ctx->recv(_Slot->_Aio);
+                        }
+                        else {
+                            _Sender->recv(_Slot->_Aio);
+                        }
+                        return;
+                    }
+                }
+                else if (_Slot->_State == SEND_SLOT::SSS_RECV) {
+                    Msg _Msg_reply = _Slot->_Aio.release_msg();
+                    _Sender->_On_sender_recv(_Msg_item_ref, _Msg_reply);
+                    _Reply_complete(_Msg_item_ref, NNG_OK, std::move(_Msg_reply));
+                }
+            }
+            else {
+                _Sender->_On_sender_exception(_Msg_item_ref, e);
+
+                _Slot->_Aio.release_msg();
+                _Reply_complete(_Msg_item_ref, e, Msg());
+            }
+
+            _Msg_item_ref = MSG_ITEM();
+            _Sender->_Slot_next(*_Slot);
+        }
+
+        // 通过发送槽发送其当前消息项
+        // 参数：_Slot - 发送槽
+        void _Slot_send(SEND_SLOT& _Slot) noexcept {
+            _Slot._State = SEND_SLOT::SSS_SEND;
+            _Set_expire(_Slot._Aio, _Slot._Msg_item);
+            _Slot._Aio.set_msg(std::move(_Slot._Msg_item._Msg));
+            if (_Slot._Ctx) {
+                _Slot._Ctx->send(_Slot._Aio);
             }
             else {
-                AsyncContext::_Send(std::move(_My_msgs.front()._Msg));
+                send(_Slot._Aio);
+            }
+        }
+
+        // 发送槽取出队列中的下一个消息，队列为空时归还为空闲槽
+        // 参数：_Slot - 发送槽
+        void _Slot_next(SEND_SLOT& _Slot) noexcept {
+            int _Lane = _My_stopping.load() ? -1 : _Queue_select();
+            if (_Lane < 0) {
+                _Slot._State = SEND_SLOT::SSS_IDLE;
+                _My_idle_slots.push_back(&_Slot);
+                return;
             }
+
+            _Queue_take(_Lane, _Slot._Msg_item);
+            _Queue_release(_Slot._Msg_item);
+            _Slot_send(_Slot);
         }
 
     private:
@@ -143,96 +1154,329 @@ namespace nng
         virtual void _On_sender_recv(MSG_ITEM& _Msg_item, Msg& m) noexcept {}
 
     protected:
-        std::queue<MSG_ITEM> _My_msgs;
+        std::deque<MSG_ITEM> _My_lanes[_PRIORITY_COUNT];    // 各优先级的排队通道
+        std::vector<std::unique_ptr<SEND_SLOT>> _My_slots;  // 并行发送槽，为空时使用 AsyncContext 自身的 aio
+        std::vector<PSEND_SLOT> _My_idle_slots;             // 空闲的发送槽
+        std::atomic<bool> _My_stopping{ false };            // 析构中，不再发起新的发送
+        std::unique_ptr<MpscQueue<MSG_ITEM>> _My_ring;      // 无锁模式下的提交队列，为空时使用 _My_lanes
+        MSG_ITEM _My_inflight;                              // 单 aio 模式和无锁模式下正在发送的消息项
+        std::atomic<bool> _My_ring_busy{ false };           // 无锁模式下的发送权
+        _Ty_send_handle _My_ring_handle = 0;                // 无锁模式下在途的可取消消息的句柄（持锁访问），0 表示没有
+        nng_err _My_ring_abort = NNG_OK;                    // 无锁模式下在途消息被中止时的错误码（持锁访问）
+        std::condition_variable_any _My_queue_cv;           // QP_BLOCK 策略下等待队列空位
+        std::atomic<size_t> _My_ring_waiters{ 0 };          // 无锁模式下 QP_BLOCK 策略等待队列空位的生产者数
+        std::atomic<size_t> _My_queue_depth{ 0 };           // 排队中的消息数
+        std::atomic<size_t> _My_queue_bytes{ 0 };           // 排队中的消息正文字节数
+        std::atomic<size_t> _My_queue_dropped{ 0 };         // 累计丢弃的消息数
+        size_t _My_limit_msgs = 0;                          // 消息数上限，0 表示不限制
+        size_t _My_limit_bytes = 0;                         // 字节数上限，0 表示不限制
+        QUEUE_POLICY _My_limit_policy = QP_BLOCK;           // 队列满时的处理策略
+        nng_duration _My_limit_timeout = NNG_DURATION_INFINITE;  // QP_BLOCK 策略下的最长等待时间
+        std::unordered_map<_Ty_send_handle, PMSG_ITEM> _My_pending;  // 排队中可取消的消息项索引
+        std::unique_ptr<TIMER> _My_timer;                   // 排队消息的截止时间定时器，首次使用时创建
+        std::atomic<_Ty_send_handle> _My_next_id{ 1 };      // 下一个发送句柄
+        LANE_POLICY _My_lane_policy = LP_STRICT;            // 优先级通道之间的调度策略
+        int _My_lane_weight[_PRIORITY_COUNT] = { 4, 1 };    // LP_WEIGHTED 策略下各通道的权重
+        int _My_lane_current[_PRIORITY_COUNT] = { 0, 0 };   // 平滑加权轮转的当前值
+        size_t _My_coalesce_bytes = 0;                      // 合并消息的最大正文长度，0 表示不合并
+        nng_duration _My_coalesce_linger = 0;               // 合并发送的最长等待时间（毫秒）
     };
 
     // AsyncSenderNoReturn 类：无返回的异步发送器，继承 AsyncSender
     // 用途：提供无回复需求的异步消息发送功能
     // 特性：
     // - 支持多种消息格式（iov、Msg、带代码的 Msg）
+    // - 支持 async_send_batch 批量提交，整批只同步一次
+    // - 支持通过 set_send_parallel 使用多个发送 aio 并行排空队列
+    // - 支持按优先级发送，控制类消息可越过排队中的批量消息
+    // - 支持通过 set_coalesce 将排队的小消息合并为一条发送
     // - 继承 AsyncSender 的线程安全和队列管理
     class AsyncSenderNoReturn : public AsyncSender
     {
     public:
+        // 设置并行发送数
+        // 参数：parallel - 同时在途的发送 aio 数量
+        // 返回：操作结果，0 表示成功；NNG_EBUSY 表示已设置过、已开启无锁模式或已有消息在途
+        // 说明：
+        // - 须在 start 之后、首次发送之前调用
+        // - 多个发送 aio 共享同一个队列，套接字层（如 Push 的负载均衡）可同时看到多条待发消息
+        // - 消息按入队顺序交给 nng，nng 按提交顺序排队，因此同一生产者的消息在单管道协议（如 Pair）上仍保持先后顺序
+        int set_send_parallel(size_t parallel) noexcept {
+            return _Create_slots(parallel, false);
+        }
+
+        // 开启小消息合并发送（Nagle 式）
+        // 参数：max_bytes - 合并消息的最大正文长度（如 16 KiB），0 表示关闭；
+        //       linger - 队列中的数据不足一个合并消息时最多等待的时间（毫秒），0 表示不等待
+        // 返回：操作结果，0 表示成功；NNG_ENOTSUP 表示已开启无锁模式或并行发送
+        // 说明：
+        // - 前一条消息在途期间积攒的小消息，在其完成后打包为一条消息发送；只有一条时原样发送
+        // - 同一优先级内保持顺序，高优先级消息不等待 linger
+        // - 接收方须为开启了 set_coalesce_unpack 的 DispatcherNoReturn（含 Service / ServiceAio），由其拆分后逐条交给 _On_raw_message / _On_message
+        // - 合并改变了消息正文的前缀，不适用于按前缀过滤的 Pub/Sub
+        int set_coalesce(size_t max_bytes, nng_duration linger = 0) noexcept {
+            return _Set_coalesce(max_bytes, linger);
+        }
+
+        // 批量异步发送消息
+        // 参数：msgs - Msg 的范围（如 std::vector<Msg>、std::span<Msg>），或 (消息代码, Msg) 对的范围
+        // 返回：操作结果，0 表示全部提交成功；否则为第一条被拒绝消息的错误码（见 set_queue_limit）
+        // 说明：
+        // - 整批只加锁一次、只触发一次发送，适合突发的大量小消息
+        // - 已提交的消息被移出范围；被拒绝的那条消息被释放，其后的消息保持原样未提交
+        template <std::ranges::forward_range _Range_t>
+        int async_send_batch(_Range_t&& msgs) noexcept {
+            return _Send_batch(std::ranges::begin(msgs), std::ranges::end(msgs),
+                [](auto& _Elem) { return _Make_batch_item(_Elem); });
+        }
+
+        // 批量异步发送带同一消息代码的消息
+        // 参数：code - 消息代码，msgs - Msg 的范围
+        // 返回：操作结果，同 async_send_batch(msgs)
+        template <std::ranges::forward_range _Range_t>
+        int async_send_batch(Msg::_Ty_msg_code code, _Range_t&& msgs) noexcept {
+            return _Send_batch(std::ranges::begin(msgs), std::ranges::end(msgs),
+                [code](Msg& _Msg) {
+                    MSG_ITEM mi;
+                    mi._Msg = std::move(_Msg);
+                    Msg::_Append_msg_code(mi._Msg, code);
+                    return mi;
+                });
+        }
+
         // 异步发送 I/O 向量数据
         // 参数：iov - I/O 向量
-        void async_send(const nng_iov& iov) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(const nng_iov& iov) noexcept {
             MSG_ITEM mi;
             mi._Msg = Msg(iov);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
         }
 
         // 异步发送消息
         // 参数：msg - 要发送的 Msg 对象
-        void async_send(Msg&& msg) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(Msg&& msg) noexcept {
             MSG_ITEM mi;
             mi._Msg = std::move(msg);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
         }
 
         // 异步发送带消息代码的 I/O 向量数据
         // 参数：code - 消息代码，iov - I/O 向量
-        void async_send(Msg::_Ty_msg_code code, const nng_iov& iov) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(Msg::_Ty_msg_code code, const nng_iov& iov) noexcept {
             MSG_ITEM mi;
             mi._Msg = Msg(iov);
             Msg::_Append_msg_code(mi._Msg, code);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
         }
 
         // 异步发送带消息代码的消息
         // 参数：code - 消息代码，msg - 要发送的 Msg 对象
-        void async_send(Msg::_Ty_msg_code code, Msg&& msg) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(Msg::_Ty_msg_code code, Msg&& msg) noexcept {
             MSG_ITEM mi;
             mi._Msg = std::move(msg);
             Msg::_Append_msg_code(mi._Msg, code);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
+        }
+
+        // 按优先级异步发送消息
+        // 参数：priority - 发送优先级，msg - 要发送的 Msg 对象
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        // 说明：同一优先级内保持提交顺序，不同优先级之间的顺序由 set_priority_policy 决定
+        int async_send(PRIORITY priority, Msg&& msg) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            mi._Priority = priority;
+            return _Send(std::move(mi));
+        }
+
+        // 按优先级异步发送带消息代码的消息
+        // 参数：priority - 发送优先级，code - 消息代码，msg - 要发送的 Msg 对象
+        // 返回：操作结果，同 async_send(priority, msg)
+        int async_send(PRIORITY priority, Msg::_Ty_msg_code code, Msg&& msg) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            Msg::_Append_msg_code(mi._Msg, code);
+            mi._Priority = priority;
+            return _Send(std::move(mi));
+        }
+
+    private:
+        // 将批量发送的元素转换为消息项
+        // 参数：msg - 要发送的 Msg 对象
+        // 返回：消息项
+        static MSG_ITEM _Make_batch_item(Msg& msg) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            return mi;
+        }
+
+        // 将批量发送的元素转换为消息项
+        // 参数：item - (消息代码, Msg) 对
+        // 返回：消息项
+        template <typename _Pair_t>
+        static MSG_ITEM _Make_batch_item(_Pair_t& item) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(std::get<1>(item));
+            Msg::_Append_msg_code(mi._Msg, std::get<0>(item));
+            return mi;
         }
     };
 
     // AsyncSenderWithReturn 类：带返回的异步发送器，继承 AsyncSender
     // 用途：提供需要回复的异步消息发送功能，支持 std::future/promise
     // 特性：
-    // - 支持异步消息发送并通过 std::future 获取回复
+    // - 支持异步消息发送并通过 std::future 获取回复，或通过内联存储的回调获取回复（无堆分配）
     // - 继承 AsyncSender 的线程安全和队列管理
+    // - 支持流水线模式：通过 set_parallel 使用 Ctx + Aio 池，多个请求同时在途
+    // - 支持单个请求的截止时间，并可通过发送句柄取消排队中或在途的请求
+    // - 支持按优先级发送，控制类请求可越过排队中的批量请求
     class AsyncSenderWithReturn : public AsyncSender
     {
     public:
+        // 设置并行请求数（流水线模式）
+        // 参数：parallel - 同时在途的请求数量，每个请求使用独立的 Ctx + Aio
+        // 返回：操作结果，0 表示成功；NNG_EBUSY 表示已设置过或已有请求在途
+        // 说明：须在 start 之后、首次发送之前调用；回复仍通过各自的 std::promise 返回
+        int set_parallel(size_t parallel) noexcept {
+            return _Create_slots(parallel, true);
+        }
+
         // 异步发送 I/O 向量数据并等待回复
         // 参数：iov - I/O 向量，promise - 用于存储回复的承诺
-        void async_send(const nng_iov& iov, std::promise<Msg>&& promise) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(const nng_iov& iov, std::promise<Msg>&& promise) noexcept {
             MSG_ITEM mi;
             mi._Msg = Msg(iov);
             mi._Promise_reply = std::move(promise);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
         }
 
         // 异步发送消息并等待回复
         // 参数：msg - 要发送的 Msg 对象，promise - 用于存储回复的承诺
-        void async_send(Msg&& msg, std::promise<Msg>&& promise) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(Msg&& msg, std::promise<Msg>&& promise) noexcept {
             MSG_ITEM mi;
             mi._Msg = std::move(msg);
             mi._Promise_reply = std::move(promise);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
         }
 
         // 异步发送带消息代码的 I/O 向量数据并等待回复
         // 参数：code - 消息代码，iov - I/O 向量，promise - 用于存储回复的承诺
-        void async_send(Msg::_Ty_msg_code code, const nng_iov& iov, std::promise<Msg>&& promise) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(Msg::_Ty_msg_code code, const nng_iov& iov, std::promise<Msg>&& promise) noexcept {
             MSG_ITEM mi;
             mi._Msg = Msg(iov);
             Msg::_Append_msg_code(mi._Msg, code);
             mi._Promise_reply = std::move(promise);
-            _Send(std::move(mi));
+            return _Send(std::move(mi));
         }
 
         // 异步发送带消息代码的消息并等待回复
         // 参数：code - 消息代码，msg - 要发送的 Msg 对象，promise - 用于存储回复的承诺
-        void async_send(Msg::_Ty_msg_code code, Msg&& msg, std::promise<Msg>&& promise) noexcept {
+        // 返回：操作结果，0 表示成功；发送队列满时的返回值见 set_queue_limit
+        int async_send(Msg::_Ty_msg_code code, Msg&& msg, std::promise<Msg>&& promise) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            Msg::_Append_msg_code(mi._Msg, code);
+            mi._Promise_reply = std::move(promise);
+            return _Send(std::move(mi));
+        }
+
+        // 异步发送消息，回复通过回调返回（无堆分配、不阻塞线程）
+        // 参数：msg - 要发送的 Msg 对象，callback - 回复回调，以 (错误码, 回复消息) 调用
+        // 返回：操作结果，0 表示成功；被队列拒绝时回调也会以同一错误码被调用
+        // 说明：回调在 aio 回调线程中执行（持有发送器互斥锁，无锁模式除外），不得阻塞或抛出异常
+        int async_send(Msg&& msg, _Ty_reply_callback&& callback) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            mi._Callback_reply = std::move(callback);
+            return _Send(std::move(mi));
+        }
+
+        // 异步发送带消息代码的消息，回复通过回调返回（无堆分配、不阻塞线程）
+        // 参数：code - 消息代码，msg - 要发送的 Msg 对象，callback - 回复回调，以 (错误码, 回复消息) 调用
+        // 返回：操作结果，同 async_send(msg, callback)
+        int async_send(Msg::_Ty_msg_code code, Msg&& msg, _Ty_reply_callback&& callback) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            Msg::_Append_msg_code(mi._Msg, code);
+            mi._Callback_reply = std::move(callback);
+            return _Send(std::move(mi));
+        }
+
+        // 按优先级异步发送带消息代码的消息，回复通过回调返回
+        // 参数：priority - 发送优先级，code - 消息代码，msg - 要发送的 Msg 对象，callback - 回复回调
+        // 返回：操作结果，同 async_send(msg, callback)
+        int async_send(PRIORITY priority, Msg::_Ty_msg_code code, Msg&& msg, _Ty_reply_callback&& callback) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            Msg::_Append_msg_code(mi._Msg, code);
+            mi._Callback_reply = std::move(callback);
+            mi._Priority = priority;
+            return _Send(std::move(mi));
+        }
+
+        // 按优先级异步发送带消息代码的消息并返回 future
+        // 参数：priority - 发送优先级，code - 消息代码，msg - 要发送的 Msg 对象
+        // 返回：std::future 用于获取回复消息
+        std::future<Msg> async_send(PRIORITY priority, Msg::_Ty_msg_code code, Msg&& msg) noexcept(false) {
+            std::promise<Msg> promise;
+            auto future = promise.get_future();
             MSG_ITEM mi;
             mi._Msg = std::move(msg);
             Msg::_Append_msg_code(mi._Msg, code);
             mi._Promise_reply = std::move(promise);
+            mi._Priority = priority;
             _Send(std::move(mi));
+            return future;
+        }
+
+        // 异步发送消息并等待回复（带截止时间，可取消）
+        // 参数：msg - 要发送的 Msg 对象，promise - 用于存储回复的承诺，
+        //       timeout - 从提交起计算的超时（毫秒），排队和在途时间都计算在内；handle - 可选，接收用于 cancel 的发送句柄
+        // 返回：操作结果，0 表示成功；超时后承诺以 NNG_ETIMEDOUT 异常结束，取消后以 NNG_ECANCELED 异常结束
+        int async_send(Msg&& msg, std::promise<Msg>&& promise, nng_duration timeout, _Ty_send_handle* handle = nullptr) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            mi._Promise_reply = std::move(promise);
+            return _Send(std::move(mi), timeout, handle);
+        }
+
+        // 异步发送带消息代码的消息并等待回复（带截止时间，可取消）
+        // 参数：code - 消息代码，msg - 要发送的 Msg 对象，promise - 用于存储回复的承诺，timeout - 超时（毫秒），handle - 可选，接收发送句柄
+        // 返回：操作结果，同 async_send(msg, promise, timeout, handle)
+        int async_send(Msg::_Ty_msg_code code, Msg&& msg, std::promise<Msg>&& promise, nng_duration timeout, _Ty_send_handle* handle = nullptr) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            Msg::_Append_msg_code(mi._Msg, code);
+            mi._Promise_reply = std::move(promise);
+            return _Send(std::move(mi), timeout, handle);
+        }
+
+        // 异步发送带消息代码的消息，回复通过回调返回（带截止时间，可取消）
+        // 参数：code - 消息代码，msg - 要发送的 Msg 对象，callback - 回复回调，timeout - 超时（毫秒），handle - 可选，接收发送句柄
+        // 返回：操作结果，同 async_send(msg, callback)；超时或取消时回调以 NNG_ETIMEDOUT / NNG_ECANCELED 调用
+        int async_send(Msg::_Ty_msg_code code, Msg&& msg, _Ty_reply_callback&& callback, nng_duration timeout, _Ty_send_handle* handle = nullptr) noexcept {
+            MSG_ITEM mi;
+            mi._Msg = std::move(msg);
+            Msg::_Append_msg_code(mi._Msg, code);
+            mi._Callback_reply = std::move(callback);
+            return _Send(std::move(mi), timeout, handle);
+        }
+
+        // 异步发送带消息代码的消息并返回 future（带截止时间，可取消）
+        // 参数：code - 消息代码，msg - 要发送的 Msg 对象，timeout - 超时（毫秒），handle - 可选，接收发送句柄
+        // 返回：std::future 用于获取回复消息，超时或取消时 get 抛出 Exception
+        std::future<Msg> async_send(Msg::_Ty_msg_code code, Msg&& msg, nng_duration timeout, _Ty_send_handle* handle = nullptr) noexcept(false) {
+            std::promise<Msg> promise;
+            auto future = promise.get_future();
+            async_send(code, std::move(msg), std::move(promise), timeout, handle);
+            return future;
         }
 
         // 异步发送消息并返回 future
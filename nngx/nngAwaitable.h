@@ -0,0 +1,365 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <exception>
+#include <coroutine>
+
+#include "nngException.h"
+#include "nngMsg.h"
+#include "nngAio.h"
+
+namespace nng
+{
+    // AioAwaitable 类：基于 nng_aio 的 C++20 协程等待对象基类
+    // 用途：在 nng_aio 上挂起协程，并在 aio 完成回调中直接恢复协程（不经过额外线程切换）
+    // 特性：
+    // - 每个等待对象持有独立的 Aio，可选持有独立的 nng_ctx，同时在途的协程互不干扰
+    // - 禁用拷贝和移动：等待对象的地址作为 aio 回调上下文，须在协程帧中保持不动
+    // - 协程在 nng 的回调线程中恢复，恢复后的代码不应长时间阻塞
+    // - 协程通常在 aio 回调中恢复并随即销毁等待对象，因此已完成的 aio 交由 nng 回收线程释放
+    // - 若协程在挂起期间被销毁，析构时停止 aio 并放弃恢复
+    // - 派生类的析构函数须先调用 _Stop，使回调不会在派生类成员销毁之后运行
+    class AioAwaitable
+    {
+    protected:
+        // 构造函数：分配 aio
+        // 异常：若 Aio 分配失败，抛出 Exception
+        AioAwaitable() noexcept(false) : _My_aio(_Callback, this) {}
+
+        // 构造函数：分配 aio，并为指定套接字打开独立的上下文
+        // 参数：socket - NNG 套接字
+        // 异常：若 Aio 分配或上下文创建失败，抛出 Exception
+        explicit AioAwaitable(nng_socket socket) noexcept(false) : _My_aio(_Callback, this) {
+            int rv = nng_ctx_open(&_My_ctx, socket);
+            if (rv != NNG_OK) {
+                throw Exception(rv, "nng_ctx_open");
+            }
+            _My_own_ctx = true;
+        }
+
+    public:
+        // 析构函数：释放 aio（未完成时先停止），然后关闭持有的上下文
+        virtual ~AioAwaitable() noexcept {
+            _Stop();
+            if (_My_own_ctx) {
+                nng_ctx_close(_My_ctx);
+            }
+        }
+
+        // 禁用拷贝构造函数
+        AioAwaitable(const AioAwaitable&) = delete;
+
+        // 禁用拷贝赋值运算符
+        AioAwaitable& operator=(const AioAwaitable&) = delete;
+
+        // 操作总是异步完成，协程总是挂起
+        // 返回：false
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        // 挂起协程并发起异步操作
+        // 参数：handle - 当前协程句柄
+        void await_suspend(std::coroutine_handle<> handle) noexcept {
+            _My_handle = handle;
+            _On_start();
+        }
+
+    protected:
+        // 停止并释放 aio：未完成时等待正在运行的回调结束，之后回调不再恢复协程
+        // 说明：各派生类的析构函数须首先调用，此时派生类成员和虚函数表仍然有效；可重复调用
+        void _Stop() noexcept {
+            if (_My_completed.load()) {
+                // 可能正处于该 aio 的回调中，不能同步等待
+                _My_aio.reap();
+            }
+            else {
+                _My_detached.store(true);
+                _My_aio.stop();
+            }
+        }
+
+        // 虚函数：发起首个异步操作
+        virtual void _On_start() noexcept = 0;
+
+        // 虚函数：处理 aio 完成
+        // 参数：e - aio 操作结果
+        // 返回：true 表示整个操作已结束、需要恢复协程；false 表示已发起后续异步操作
+        virtual bool _On_complete(nng_err e) noexcept {
+            _My_result = e;
+            return true;
+        }
+
+        // 若操作失败，抛出 Exception
+        // 参数：what - 失败的操作名称
+        // 异常：若操作结果不为 NNG_OK，抛出 Exception
+        void _Throw_if_failed(const char* what) const noexcept(false) {
+            if (_My_result != NNG_OK) {
+                throw Exception(_My_result, what);
+            }
+        }
+
+    private:
+        // 回调函数：aio 完成时在 nng 回调线程中恢复协程
+        // 参数：callback_context - 回调上下文（指向 AioAwaitable）
+        static void _Callback(void* callback_context) noexcept {
+            auto _Awaitable = static_cast<AioAwaitable*>(callback_context);
+            if (_Awaitable->_My_detached.load()) {
+                return;
+            }
+            if (_Awaitable->_On_complete(_Awaitable->_My_aio.result())) {
+                _Awaitable->_My_completed.store(true);
+                _Awaitable->_My_handle.resume();
+            }
+        }
+
+    protected:
+        Aio _My_aio;
+        nng_ctx _My_ctx = NNG_CTX_INITIALIZER;
+        bool _My_own_ctx = false;
+        std::atomic<bool> _My_detached{ false };      // 已析构，回调不再恢复协程
+        std::atomic<bool> _My_completed{ false };     // 操作已结束，协程已（或即将）恢复
+        nng_err _My_result = NNG_OK;
+        std::coroutine_handle<> _My_handle;
+    };
+
+    // RecvAwaitable 类：接收一条消息的协程等待对象
+    // 用途：co_await sock.async_recv() / co_await ctx.async_recv()
+    // 返回：接收到的 Msg 对象
+    // 异常：若接收失败，co_await 抛出 Exception
+    class RecvAwaitable : public AioAwaitable
+    {
+    public:
+        // 构造函数：在套接字上接收
+        // 参数：socket - NNG 套接字
+        // 异常：若 Aio 分配失败，抛出 Exception
+        explicit RecvAwaitable(nng_socket socket) noexcept(false) : _My_socket(socket) {}
+
+        // 构造函数：在上下文上接收（不持有上下文）
+        // 参数：ctx - NNG 上下文
+        // 异常：若 Aio 分配失败，抛出 Exception
+        explicit RecvAwaitable(nng_ctx ctx) noexcept(false) : _My_use_ctx(true) {
+            _My_ctx = ctx;
+        }
+
+        // 析构函数：先停止 aio
+        virtual ~RecvAwaitable() noexcept {
+            _Stop();
+        }
+
+        // 恢复协程时获取接收结果
+        // 返回：接收到的 Msg 对象
+        // 异常：若接收失败，抛出 Exception
+        Msg await_resume() noexcept(false) {
+            _Throw_if_failed("nng_recv_aio");
+            return _My_aio.release_msg();
+        }
+
+    private:
+        // 发起接收操作
+        virtual void _On_start() noexcept override {
+            if (_My_use_ctx) {
+                nng_ctx_recv(_My_ctx, _My_aio);
+            }
+            else {
+                nng_recv_aio(_My_socket, _My_aio);
+            }
+        }
+
+    private:
+        nng_socket _My_socket = NNG_SOCKET_INITIALIZER;
+        bool _My_use_ctx = false;
+    };
+
+    // CallAwaitable 类：发送请求并接收回复的协程等待对象（Req 协议）
+    // 用途：co_await req.async_call(msg)
+    // 特性：每次调用使用独立的上下文，成千上万个请求可同时在途
+    // 返回：回复的 Msg 对象
+    // 异常：若上下文创建、发送或接收失败，co_await 抛出 Exception
+    class CallAwaitable : public AioAwaitable
+    {
+    public:
+        // 构造函数：准备发送请求消息
+        // 参数：socket - Req 协议套接字，msg - 请求消息
+        // 异常：若 Aio 分配或上下文创建失败，抛出 Exception
+        CallAwaitable(nng_socket socket, Msg&& msg) noexcept(false)
+            : AioAwaitable(socket), _My_msg(std::move(msg)) {
+        }
+
+        // 析构函数：先停止 aio，再销毁请求消息
+        virtual ~CallAwaitable() noexcept {
+            _Stop();
+        }
+
+        // 恢复协程时获取回复消息
+        // 返回：回复的 Msg 对象
+        // 异常：若发送或接收失败，抛出 Exception
+        Msg await_resume() noexcept(false) {
+            _Throw_if_failed(_My_sent ? "nng_ctx_recv" : "nng_ctx_send");
+            return _My_aio.release_msg();
+        }
+
+    private:
+        // 通过独立上下文发送请求
+        virtual void _On_start() noexcept override {
+            _My_aio.set_msg(std::move(_My_msg));
+            nng_ctx_send(_My_ctx, _My_aio);
+        }
+
+        // 发送完成后继续在同一上下文上接收回复
+        virtual bool _On_complete(nng_err e) noexcept override {
+            if (e != NNG_OK) {
+                if (!_My_sent) {
+                    // 发送失败时消息仍归 aio 所有，需要释放
+                    _My_aio.release_msg();
+                }
+                return AioAwaitable::_On_complete(e);
+            }
+            if (!_My_sent) {
+                _My_sent = true;
+                nng_ctx_recv(_My_ctx, _My_aio);
+                return false;
+            }
+            return AioAwaitable::_On_complete(e);
+        }
+
+    private:
+        Msg _My_msg;
+        bool _My_sent = false;
+    };
+
+    // CallCodeAwaitable 类：发送带消息代码的请求并接收结果的协程等待对象（Req 协议）
+    // 用途：co_await req.async_call(code, msg)，与同步的 Socket::send(code, msg) 语义一致
+    // 返回：消息结果，msg 被替换为回复消息（已去除消息结果）
+    // 异常：若上下文创建、发送、接收失败或回复中不包含消息结果，co_await 抛出 Exception
+    class CallCodeAwaitable : public CallAwaitable
+    {
+    public:
+        // 构造函数：准备发送带消息代码的请求消息
+        // 参数：socket - Req 协议套接字，code - 消息代码，msg - 请求消息，须在 co_await 结束前保持有效
+        // 异常：若 Aio 分配、上下文创建或消息分配失败，抛出 Exception
+        CallCodeAwaitable(nng_socket socket, Msg::_Ty_msg_code code, Msg& msg) noexcept(false)
+            : CallAwaitable(socket, _Prepare(code, msg)), _My_reply_to(msg) {
+        }
+
+        // 析构函数：先停止 aio
+        virtual ~CallCodeAwaitable() noexcept {
+            _Stop();
+        }
+
+        // 恢复协程时获取消息结果
+        // 返回：消息结果
+        // 异常：若发送或接收失败，或回复中不包含消息结果，抛出 Exception
+        Msg::_Ty_msg_result await_resume() noexcept(false) {
+            _My_reply_to = CallAwaitable::await_resume();
+            return Msg::_Chop_msg_result(_My_reply_to);
+        }
+
+    private:
+        // 为请求消息追加消息代码，并转移消息所有权
+        // 参数：code - 消息代码，msg - 请求消息
+        // 返回：追加了消息代码的请求消息
+        // 异常：若消息分配失败，抛出 Exception
+        static Msg&& _Prepare(Msg::_Ty_msg_code code, Msg& msg) noexcept(false) {
+            if (!msg) {
+                int rv = msg.realloc(0);
+                if (rv != NNG_OK) {
+                    throw Exception(rv, "realloc");
+                }
+            }
+            Msg::_Append_msg_code(msg, code);
+            return std::move(msg);
+        }
+
+    private:
+        Msg& _My_reply_to;
+    };
+
+    // CollectAwaitable 类：发送调查并收集回复的协程等待对象（Surveyor 协议）
+    // 用途：co_await survey.async_collect(msg)
+    // 特性：每次调查使用独立的上下文；调查时间（NNG_OPT_SURVEYOR_SURVEYTIME）到期或收满 max_replies 条回复后恢复协程
+    // 返回：收集到的回复消息列表
+    // 异常：若上下文创建、发送失败或接收出现超时以外的错误，抛出 Exception
+    class CollectAwaitable : public AioAwaitable
+    {
+    public:
+        // 构造函数：准备发送调查消息
+        // 参数：socket - Surveyor 协议套接字，msg - 调查消息，max_replies - 最多收集的回复数
+        // 异常：若 Aio 分配或上下文创建失败，抛出 Exception
+        CollectAwaitable(nng_socket socket, Msg&& msg, size_t max_replies = (std::numeric_limits<size_t>::max)()) noexcept(false)
+            : AioAwaitable(socket), _My_msg(std::move(msg)), _My_max_replies(max_replies) {
+        }
+
+        // 析构函数：先停止 aio，再销毁已收集的回复
+        virtual ~CollectAwaitable() noexcept {
+            _Stop();
+        }
+
+        // 恢复协程时获取收集到的回复
+        // 返回：回复消息列表
+        // 异常：若发送失败或接收出现超时以外的错误，抛出 Exception
+        std::vector<Msg> await_resume() noexcept(false) {
+            _Throw_if_failed(_My_sent ? "nng_ctx_recv" : "nng_ctx_send");
+            return std::move(_My_replies);
+        }
+
+    private:
+        // 通过独立上下文发送调查
+        virtual void _On_start() noexcept override {
+            _My_aio.set_msg(std::move(_My_msg));
+            nng_ctx_send(_My_ctx, _My_aio);
+        }
+
+        // 发送完成后持续接收，直到调查超时或收满
+        virtual bool _On_complete(nng_err e) noexcept override {
+            if (e != NNG_OK) {
+                if (!_My_sent) {
+                    _My_aio.release_msg();
+                }
+                // 调查时间到期属于正常结束
+                return AioAwaitable::_On_complete(_My_sent && e == NNG_ETIMEDOUT ? NNG_OK : e);
+            }
+
+            if (_My_sent) {
+                try {
+                    _My_replies.push_back(_My_aio.release_msg());
+                }
+                catch (const std::bad_alloc&) {
+                    return AioAwaitable::_On_complete(NNG_ENOMEM);
+                }
+                if (_My_replies.size() >= _My_max_replies) {
+                    return AioAwaitable::_On_complete(NNG_OK);
+                }
+            }
+
+            _My_sent = true;
+            nng_ctx_recv(_My_ctx, _My_aio);
+            return false;
+        }
+
+    private:
+        Msg _My_msg;
+        size_t _My_max_replies;
+        std::vector<Msg> _My_replies;
+        bool _My_sent = false;
+    };
+
+    // Detached 类：立即开始执行、无需等待结果的最简协程返回类型
+    // 用途：在没有第三方协程库时驱动上述等待对象，如 Detached f() { auto m = co_await sock.async_recv(); ... }
+    // 特性：
+    // - 协程创建后立即执行，结束时自动销毁协程帧
+    // - 协程内未捕获的异常会终止程序，调用方须自行捕获
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+}
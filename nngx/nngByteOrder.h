@@ -0,0 +1,193 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// x86 上批量转换按运行时检测到的指令集选择 AVX2 或 SSSE3 实现，不依赖编译选项
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define NNGX_BYTEORDER_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define NNGX_BYTEORDER_TARGET(isa)
+#else
+#define NNGX_BYTEORDER_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace nng
+{
+    // 字段的字节序策略
+    enum FIELD_ORDER
+    {
+        FO_NETWORK,     // 整数、浮点数和枚举按网络字节序（大端）编码，与 Msg::append_u* / chop_u* 一致
+        FO_NATIVE       // 按本机内存表示原样复制
+    };
+
+    // ByteOrder 类：字节序转换
+    // 用途：为 Pod 的字段编解码和 Msg 的 *_array 批量编解码提供网络字节序与本机字节序之间的转换
+    // 特性：
+    // - 网络字节序与本机字节序的转换是对称的，编码和解码使用同一函数
+    // - 批量转换在 x86 上按运行时检测结果选择指令集：AVX2 每次处理 32 字节，SSSE3 每次处理 16 字节，其余部分逐个转换
+    // - FO_NATIVE 或大端主机上只做 memcpy
+    class ByteOrder
+    {
+    public:
+        // 反转无符号整数的字节序
+        // 参数：val - 要转换的值
+        // 返回：转换后的值
+        template <typename T>
+        static constexpr T swap(T val) noexcept {
+            static_assert(std::is_unsigned_v<T>, "ByteOrder::swap requires an unsigned integer");
+            T _Result = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                _Result = (T)((_Result << 8) | (val & 0xFF));
+                val = (T)(val >> 8);
+            }
+            return _Result;
+        }
+
+        // 批量复制整数并按策略转换字节序
+        // 参数：dst - 目标地址，src - 源地址（可与 dst 相同，不能部分重叠），count - 元素个数，order - 字节序策略
+        template <typename T>
+        static void copy(void* dst, const void* src, size_t count, FIELD_ORDER order = FO_NETWORK) noexcept {
+            static_assert(std::is_integral_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8),
+                "ByteOrder::copy requires 8, 16, 32 or 64-bit integers");
+            if (sizeof(T) == 1 || order == FO_NATIVE || std::endian::native == std::endian::big) {
+                if (dst != src && count != 0) {
+                    std::memcpy(dst, src, count * sizeof(T));
+                }
+                return;
+            }
+            if constexpr (sizeof(T) > 1) {
+                _Swap_copy<sizeof(T)>(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), count);
+            }
+        }
+
+    private:
+        // 与 _Size 等宽的无符号整数
+        template <size_t _Size>
+        using _Bits_t = std::conditional_t<_Size == 2, uint16_t, std::conditional_t<_Size == 4, uint32_t, uint64_t>>;
+
+        // 反转每个 _Size 字节元素的 shuffle 掩码（AVX2 的两个 128 位通道相同）
+        template <size_t _Size>
+        static constexpr std::array<uint8_t, 32> _Shuffle_mask() noexcept {
+            std::array<uint8_t, 32> _Mask{};
+            for (size_t i = 0; i < 32; ++i) {
+                _Mask[i] = (uint8_t)((i % 16) / _Size * _Size + (_Size - 1 - i % _Size));
+            }
+            return _Mask;
+        }
+
+        // 批量转换：SIMD 处理整块，剩余元素逐个转换
+        template <size_t _Size>
+        static void _Swap_copy(uint8_t* dst, const uint8_t* src, size_t count) noexcept {
+            size_t _Bytes = count * _Size;
+            size_t i = 0;
+#if defined(NNGX_BYTEORDER_SIMD)
+            switch (_Simd_level()) {
+            case _SIMD_AVX2:
+                i = _Swap_avx2<_Size>(dst, src, _Bytes);
+                break;
+            case _SIMD_SSSE3:
+                i = _Swap_ssse3<_Size>(dst, src, _Bytes);
+                break;
+            default:
+                break;
+            }
+#endif
+            for (; i < _Bytes; i += _Size) {
+                _Bits_t<_Size> _Val;
+                std::memcpy(&_Val, src + i, _Size);
+                _Val = swap(_Val);
+                std::memcpy(dst + i, &_Val, _Size);
+            }
+        }
+
+#if defined(NNGX_BYTEORDER_SIMD)
+        // 可用的 SIMD 指令集
+        enum SIMD_LEVEL
+        {
+            _SIMD_NONE,
+            _SIMD_SSSE3,
+            _SIMD_AVX2
+        };
+
+        // 获取当前 CPU 支持的 SIMD 指令集，首次调用时检测
+        // 返回：SIMD_LEVEL
+        static int _Simd_level() noexcept {
+#if defined(__AVX2__)
+            return _SIMD_AVX2;
+#else
+            static const int _Level = _Detect_simd();
+            return _Level;
+#endif
+        }
+
+        // 检测 CPU 与操作系统是否支持 AVX2、SSSE3
+        // 返回：SIMD_LEVEL
+        static int _Detect_simd() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int _Info[4];
+            __cpuid(_Info, 0);
+            int _Max_leaf = _Info[0];
+            __cpuid(_Info, 1);
+            bool _Ssse3 = (_Info[2] & (1 << 9)) != 0;
+            // AVX2 还需要操作系统保存 YMM 寄存器（OSXSAVE 且 XCR0 的 XMM、YMM 位）
+            bool _Avx = (_Info[2] & (1 << 27)) != 0 && (_Info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+            bool _Avx2 = false;
+            if (_Avx && _Max_leaf >= 7) {
+                __cpuidex(_Info, 7, 0);
+                _Avx2 = (_Info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            bool _Ssse3 = __builtin_cpu_supports("ssse3");
+            bool _Avx2 = __builtin_cpu_supports("avx2");
+#endif
+            return _Avx2 ? _SIMD_AVX2 : _Ssse3 ? _SIMD_SSSE3 : _SIMD_NONE;
+        }
+
+        // AVX2 批量转换，先按 32 字节、再按 16 字节处理
+        // 返回：已处理的字节数
+        template <size_t _Size>
+        NNGX_BYTEORDER_TARGET("avx2")
+        static size_t _Swap_avx2(uint8_t* dst, const uint8_t* src, size_t bytes) noexcept {
+            alignas(32) static constexpr std::array<uint8_t, 32> _Mask = _Shuffle_mask<_Size>();
+            size_t i = 0;
+            const __m256i _Mask256 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_Mask.data()));
+            for (; i + 32 <= bytes; i += 32) {
+                __m256i _V = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(_V, _Mask256));
+            }
+            const __m128i _Mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(_Mask.data()));
+            for (; i + 16 <= bytes; i += 16) {
+                __m128i _V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(_V, _Mask128));
+            }
+            return i;
+        }
+
+        // SSSE3 批量转换，按 16 字节处理
+        // 返回：已处理的字节数
+        template <size_t _Size>
+        NNGX_BYTEORDER_TARGET("ssse3")
+        static size_t _Swap_ssse3(uint8_t* dst, const uint8_t* src, size_t bytes) noexcept {
+            alignas(16) static constexpr std::array<uint8_t, 32> _Mask = _Shuffle_mask<_Size>();
+            size_t i = 0;
+            const __m128i _Mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(_Mask.data()));
+            for (; i + 16 <= bytes; i += 16) {
+                __m128i _V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(_V, _Mask128));
+            }
+            return i;
+        }
+#endif
+    };
+}
+
+#undef NNGX_BYTEORDER_TARGET
@@ -73,6 +73,13 @@ namespace nng
             nng_ctx_recv(_My_ctx, aio);
         }
 
+        // 协程接收消息：co_await ctx.async_recv()
+        // 返回：协程等待对象，co_await 得到接收到的 Msg 对象，接收失败时抛出 Exception
+        // 异常：若 Aio 分配失败，抛出 Exception
+        RecvAwaitable async_recv() const noexcept(false) {
+            return RecvAwaitable(_My_ctx);
+        }
+
         // 同步接收消息
         // 参数：flags - 接收标志，默认为 0
         // 返回：接收到的 Msg 对象
@@ -86,6 +93,19 @@ namespace nng
             return Msg(m);
         }
 
+        // 同步接收消息到指定对象
+        // 参数：msg - 存储接收消息的 Msg 对象，flags - 接收标志，默认为 0
+        // 返回：操作结果，0 表示成功
+        int recv(Msg& msg, int flags = 0) const noexcept {
+            nng_msg* m = nullptr;
+            int rv = nng_ctx_recvmsg(_My_ctx, &m, flags);
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            msg = Msg(m);
+            return rv;
+        }
+
         // 异步发送消息
         // 参数：aio - 异步 I/O 对象
         void send(nng_aio* aio) const noexcept {
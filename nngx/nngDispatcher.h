@@ -1,8 +1,18 @@
 #pragma once
 
+#include <span>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <condition_variable>
+
 #include "nngException.h"
 #include "nngMsg.h"
 #include "nngSocket.h"
+#include "nngCtx.h"
+#include "nngQueue.h"
 
 namespace nng
 {
@@ -10,24 +20,27 @@ namespace nng
     // 用途：定义消息处理回调，供派生类实现具体分发逻辑
     // 特性：
     // - 提供处理原始消息和编码消息的虚函数
-    // - 支持异常处理回调
+    // - 接收循环基于错误码，不抛出异常；接收错误经 _On_dispatch_error 处理，重写后超时不必构造异常
+    // - 可在套接字或指定的 Ctx 上分发，多个线程各自使用一个 Ctx 即可并行处理
+    // - 支持错误码和异常处理回调
     class Dispatcher : virtual public Socket
     {
     public:
+        // 协议是否支持在多个 Ctx 上并行分发（Rep、Respondent、Sub 支持），由 Service 多线程分发时使用
+        static constexpr bool _Dispatch_with_ctx = false;
+
         // 分发消息
-        // 循环接收消息并调用处理回调，直至异常终止
+        // 循环接收消息并调用处理回调，直至 _On_dispatch_error 要求停止
+        // 说明：接收失败只返回错误码，不抛出异常；重写 _On_dispatch_error 的轮询者每次超时只多一次分支判断
         void dispatch() noexcept {
-            for (;;) {
-                try {
-                    Msg m = recv();
-                    _On_recv(m);
-                }
-                catch (const Exception& e) {
-                    if (_On_dispatch_exception(e)) {
-                        break;
-                    }
-                }
-            }
+            _Dispatch(nullptr);
+        }
+
+        // 在指定的上下文上分发消息
+        // 参数：ctx - 上下文，接收和回复都在该上下文上进行
+        // 说明：同 dispatch()；多个线程各自在不同的 Ctx 上分发时，处理回调会被并发调用
+        void dispatch(const Ctx& ctx) noexcept {
+            _Dispatch(&ctx);
         }
     protected:
         // 虚函数：处理原始消息
@@ -45,27 +58,349 @@ namespace nng
         // 返回：true 表示停止分发，false 表示继续
         virtual bool _On_dispatch_exception(const Exception& e) { return true; }
 
+        // 虚函数：分发用的上下文创建后调用（Service 多线程分发时）
+        // 参数：ctx - 新创建的上下文
+        // 返回：操作结果，0 表示成功，非 0 时放弃启动分发
+        // 说明：Sub 协议的订阅属于各个上下文，须在此为每个上下文订阅主题
+        virtual int _On_dispatch_ctx(const Ctx& ctx) { return NNG_OK; }
+
+        // 虚函数：处理接收错误
+        // 参数：e - 错误码
+        // 返回：true 表示停止分发，false 表示继续
+        // 说明：
+        // - 默认把所有错误（包括 NNG_ETIMEDOUT）构造为 Exception 交给 _On_dispatch_exception，与原有行为一致：
+        //   _On_dispatch_exception 默认返回 true，设置了接收超时的分发在首次超时时结束
+        // - 轮询场景可重写本函数，对 NNG_ETIMEDOUT / NNG_EAGAIN 直接返回 false 或在此做周期性工作，免去构造异常
+        virtual bool _On_dispatch_error(nng_err e) {
+            return _On_dispatch_exception(Exception(e, "dispatch"));
+        }
+
     private:
+        // 接收循环
+        // 参数：ctx - 上下文，nullptr 表示直接使用套接字
+        void _Dispatch(const Ctx* ctx) noexcept {
+            for (;;) {
+                Msg m;
+                int rv = ctx ? ctx->recv(m) : recv(m);
+                if (rv != NNG_OK) {
+                    if (_On_dispatch_error(rv)) {
+                        break;
+                    }
+                    continue;
+                }
+                if (_On_recv(m, ctx)) {
+                    break;
+                }
+            }
+        }
+
         // 虚函数：处理接收到的消息
-        // 参数：m - 接收的 Msg 对象
-        virtual void _On_recv(Msg& m) noexcept = 0;
+        // 参数：m - 接收的 Msg 对象，ctx - 接收所在的上下文，nullptr 表示套接字
+        // 返回：true 表示停止分发（处理消息时出错且 _On_dispatch_error 要求停止），false 表示继续
+        virtual bool _On_recv(Msg& m, const Ctx* ctx) noexcept = 0;
     };
 
     // DispatcherNoReturn 类：无返回的消息分发器，继承 Dispatcher 和 Socket
     // 用途：处理接收的消息，无需发送回复
     // 特性：
     // - 循环接收并处理消息
+    // - 可通过 set_coalesce_unpack 拆分发送方合并的小消息（见 AsyncSenderNoReturn::set_coalesce），逐条处理
+    // - 可通过 set_key_ordered 按 _On_dispatch_key 返回的键把消息分到多个工作通道：同一键的消息按接收顺序处理，不同键并行处理
+    // - 可通过 set_batch 在一次阻塞接收之后以非阻塞方式继续接收，把多条消息一起交给 _On_batch
     // - 支持异常处理
     class DispatcherNoReturn : public Dispatcher
     {
+        // 按键保序分发的工作通道：接收线程是唯一的生产者，通道线程是唯一的消费者
+        typedef struct _LANE
+        {
+            SpscQueue<Msg> _Queue;
+            std::thread _Thread;
+            std::mutex _Mtx;                        // 与 _Cv 配合，仅在通道线程休眠和唤醒时使用
+            std::condition_variable _Cv;
+            std::atomic<bool> _Sleeping{ false };   // 通道线程是否准备休眠，接收线程据此决定是否唤醒
+            std::atomic<size_t> _Pending{ 0 };      // 已入队但尚未处理完成的消息数
+            std::atomic<uint32_t> _Popped{ 0 };     // 通道线程已取出的消息数（允许回绕），接收线程在通道已满时等待其变化
+            std::atomic<bool> _Full_wait{ false };  // 接收线程是否因通道已满而等待，通道线程据此决定是否唤醒
+
+            // 通道构造函数
+            // 参数：capacity - 队列容量
+            // 异常：若分配失败，抛出 std::bad_alloc
+            explicit _LANE(size_t capacity) noexcept(false) : _Queue(capacity) {
+            }
+        } LANE, * PLANE;
+
+    public:
+        // 析构函数：处理完已入队的消息后停止工作通道
+        virtual ~DispatcherNoReturn() {
+            stop_key_ordered();
+        }
+
+        // 开启按键保序的并行分发
+        // 参数：lanes - 工作通道数（每个通道一个线程），capacity - 每个通道的队列容量
+        // 返回：操作结果，0 表示成功；NNG_EINVAL 表示参数无效；NNG_EBUSY 表示已经开启
+        // 异常：若分配或创建线程失败，抛出 std::bad_alloc 或 std::system_error
+        // 说明：
+        // - 须在启动分发之前调用；Service、ServiceAio 开启后只使用一个接收者，以保证通道队列只有一个生产者
+        // - 消息按 _On_dispatch_key 返回的键散列到通道，同一键的消息在同一通道中按接收顺序处理
+        // - 通道队列已满时接收线程阻塞等待（不占用 CPU），对发送方形成背压
+        int set_key_ordered(size_t lanes, size_t capacity = 1024) noexcept(false) {
+            if (lanes == 0 || capacity == 0) {
+                return NNG_EINVAL;
+            }
+            if (!_My_lanes.empty()) {
+                return NNG_EBUSY;
+            }
+
+            _My_lanes_stopping.store(false);
+            _My_lanes.reserve(lanes);
+            for (size_t i = 0; i < lanes; ++i) {
+                _My_lanes.emplace_back(std::make_unique<LANE>(capacity));
+            }
+            for (auto& _Lane : _My_lanes) {
+                _Lane->_Thread = std::thread(&DispatcherNoReturn::_Run_lane, this, _Lane.get());
+            }
+            return NNG_OK;
+        }
+
+        // 设置批量分发
+        // 参数：max_count - 每批最多消息数，小于等于 1 表示关闭批量分发；max_bytes - 每批最多字节数，0 表示不限；
+        //       max_time - 每批最多继续接收的时间（毫秒），0 表示不限
+        // 返回：操作结果，0 表示成功
+        // 说明：
+        // - 须在启动分发之前调用
+        // - 收到一条消息后以 NNG_FLAG_NONBLOCK 继续接收，直至没有排队的消息或达到任一上限，然后一起交给 _On_batch
+        // - 合并发送的消息拆分后逐条计入，一批可能略超出上限
+        // - 开启按键保序分发时不生效
+        int set_batch(size_t max_count, size_t max_bytes = 0, nng_duration max_time = 0) noexcept {
+            if (max_time < 0) {
+                return NNG_EINVAL;
+            }
+            _My_batch_count = max_count;
+            _My_batch_bytes = max_bytes;
+            _My_batch_time = max_time;
+            return NNG_OK;
+        }
+
+        // 开启或关闭合并消息的拆分
+        // 参数：on - true 开启，false 关闭（默认）
+        // 说明：
+        // - 须在启动分发之前调用，与发送方的 AsyncSenderNoReturn::set_coalesce 配合使用
+        // - 开启后正文末尾为合并消息代码的消息被拆分为内部消息逐条处理；关闭时所有消息原样处理
+        // - 帧格式错误的合并消息被整条丢弃，并以 NNG_EPROTO 调用 _On_dispatch_error
+        void set_coalesce_unpack(bool on = true) noexcept {
+            _My_unpack = on;
+        }
+
+        // 检查是否开启了合并消息的拆分
+        // 返回：true 表示已开启
+        bool coalesce_unpack() const noexcept {
+            return _My_unpack;
+        }
+
+        // 检查是否开启了按键保序的并行分发
+        // 返回：true 表示已开启
+        bool key_ordered() const noexcept {
+            return !_My_lanes.empty();
+        }
+
+        // 停止按键保序的并行分发：处理完已入队的消息后结束全部通道线程
+        // 说明：须在接收停止之后调用；之后的消息恢复在接收线程中直接处理
+        void stop_key_ordered() noexcept {
+            if (_My_lanes.empty()) {
+                return;
+            }
+
+            _My_lanes_stopping.store(true);
+            for (auto& _Lane : _My_lanes) {
+                {
+                    std::scoped_lock locker(_Lane->_Mtx);
+                }
+                _Lane->_Cv.notify_one();
+            }
+            for (auto& _Lane : _My_lanes) {
+                _Lane->_Thread.join();
+            }
+            _My_lanes.clear();
+        }
 
     protected:
-        virtual void _On_recv(Msg& m) noexcept override {
+        // 虚函数：提取消息的分发键（按键保序分发时）
+        // 参数：msg - 接收的 Msg 对象（尚未裁剪消息代码）
+        // 返回：分发键，相同键的消息按接收顺序处理
+        // 说明：在接收线程中调用，应只读取消息内容
+        virtual uint64_t _On_dispatch_key(const Msg& msg) { return 0; }
+
+        // 虚函数：批量处理消息（开启批量分发时）
+        // 参数：msgs - 一批消息，按接收顺序排列，尚未裁剪消息代码（可用 Msg::_Chop_msg_code 裁剪）
+        // 说明：默认逐条交给 _On_raw_message / _On_message；消息可被移走，调用返回后即被释放
+        virtual void _On_batch(std::span<Msg> msgs) {
+            for (auto& m : msgs) {
+                _Dispatch_msg(m);
+            }
+        }
+
+        // 等待已入队的消息全部处理完成（按键保序分发时）
+        // 说明：须在接收停止之后调用，阻塞等待各通道的计数归零；不得在通道线程（处理回调）中调用
+        void _Drain_key_ordered() noexcept {
+            for (auto& _Lane : _My_lanes) {
+                assert(_Lane->_Thread.get_id() != std::this_thread::get_id());
+                for (size_t _Count = _Lane->_Pending.load(); _Count != 0; _Count = _Lane->_Pending.load()) {
+                    _Lane->_Pending.wait(_Count);
+                }
+            }
+        }
+
+        virtual bool _On_recv(Msg& m, const Ctx* ctx) noexcept override {
+            if (_My_batch_count > 1 && _My_lanes.empty()) {
+                return _Recv_batch(m, ctx);
+            }
+
+            if (_My_unpack && Msg::_Is_packed_msg(m)) {
+                int rv = Msg::_Unpack_msg(m, [this](Msg& _Inner) { _Route_msg(_Inner); });
+                if (rv != NNG_OK) {
+                    return _On_dispatch_error(rv);
+                }
+            }
+            else {
+                _Route_msg(m);
+            }
+            return false;
+        }
+
+    private:
+        // 批量接收：以非阻塞方式继续接收直至队列为空或达到上限，然后交给 _On_batch
+        // 参数：m - 已接收的第一条消息，ctx - 接收所在的上下文，nullptr 表示套接字
+        // 返回：true 表示拆分合并消息出错且 _On_dispatch_error 要求停止；已收集的消息仍交给 _On_batch
+        bool _Recv_batch(Msg& m, const Ctx* ctx) {
+            // 复用线程内的缓冲区，避免每批分配；先取出以支持处理回调中的重入
+            static thread_local std::vector<Msg> _Tls_batch;
+            std::vector<Msg> _Batch = std::move(_Tls_batch);
+            size_t _Bytes = 0;
+            bool _Stop = false;
+
+            auto _Collect = [this, &_Batch, &_Bytes, &_Stop](Msg& _Msg) {
+                if (_My_unpack && Msg::_Is_packed_msg(_Msg)) {
+                    int rv = Msg::_Unpack_msg(_Msg, [&_Batch, &_Bytes](Msg& _Inner) {
+                        _Bytes += _Inner.len();
+                        _Batch.push_back(std::move(_Inner));
+                    });
+                    if (rv != NNG_OK) {
+                        _Stop = _On_dispatch_error(rv);
+                    }
+                }
+                else {
+                    _Bytes += _Msg.len();
+                    _Batch.push_back(std::move(_Msg));
+                }
+            };
+
+            _Collect(m);
+            nng_time _Deadline = _My_batch_time > 0 ? nng_clock() + _My_batch_time : 0;
+            while (!_Stop
+                && _Batch.size() < _My_batch_count
+                && (_My_batch_bytes == 0 || _Bytes < _My_batch_bytes)
+                && (_Deadline == 0 || nng_clock() < _Deadline)) {
+                Msg _Next;
+                int rv = ctx ? ctx->recv(_Next, NNG_FLAG_NONBLOCK) : recv(_Next, NNG_FLAG_NONBLOCK);
+                if (rv != NNG_OK) {
+                    // NNG_EAGAIN 表示暂无消息；其它错误留给下一次阻塞接收处理
+                    break;
+                }
+                _Collect(_Next);
+            }
+
+            if (!_Batch.empty()) {
+                _On_batch(std::span<Msg>(_Batch));
+            }
+            _Batch.clear();
+            _Tls_batch = std::move(_Batch);
+            return _Stop;
+        }
+
+        // 处理或转交一条消息：开启按键保序分发时放入键对应的通道，否则直接处理
+        // 参数：m - 消息对象，转交时被移走
+        void _Route_msg(Msg& m) {
+            if (_My_lanes.empty()) {
+                _Dispatch_msg(m);
+                return;
+            }
+
+            // 散列键，使相邻的键也均匀分布到各个通道
+            uint64_t _Key = _On_dispatch_key(m);
+            _Key ^= _Key >> 33;
+            _Key *= 0xFF51AFD7ED558CCDull;
+            _Key ^= _Key >> 33;
+            LANE& _Lane = *_My_lanes[_Key % _My_lanes.size()];
+
+            _Lane._Pending.fetch_add(1);
+            while (!_Lane._Queue.try_push(std::move(m))) {
+                // 通道已满：先登记等待再试一次，仍满时阻塞到通道线程取出消息
+                uint32_t _Seen = _Lane._Popped.load();
+                _Lane._Full_wait.store(true);
+                if (_Lane._Queue.try_push(std::move(m))) {
+                    _Lane._Full_wait.store(false);
+                    break;
+                }
+                _Lane._Popped.wait(_Seen);
+                _Lane._Full_wait.store(false);
+            }
+
+            // 与通道线程设置 _Sleeping 后检查队列相对应，保证不会错过唤醒
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_Lane._Sleeping.load(std::memory_order_relaxed)) {
+                {
+                    std::scoped_lock locker(_Lane._Mtx);
+                }
+                _Lane._Cv.notify_one();
+            }
+        }
+
+        // 通道线程主循环：按入队顺序处理消息，队列为空时休眠
+        // 参数：_Lane - 工作通道
+        void _Run_lane(PLANE _Lane) noexcept {
+            Msg m;
+            for (;;) {
+                if (_Lane->_Queue.try_pop(m)) {
+                    // 与接收线程先登记等待、再检查队列相对应，保证不会错过唤醒
+                    _Lane->_Popped.fetch_add(1);
+                    if (_Lane->_Full_wait.load()) {
+                        _Lane->_Popped.notify_one();
+                    }
+                    _Dispatch_msg(m);
+                    m = Msg();
+                    if (_Lane->_Pending.fetch_sub(1) == 1) {
+                        _Lane->_Pending.notify_all();
+                    }
+                    continue;
+                }
+
+                std::unique_lock locker(_Lane->_Mtx);
+                _Lane->_Sleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                _Lane->_Cv.wait(locker, [this, _Lane] { return !_Lane->_Queue.empty() || _My_lanes_stopping.load(); });
+                _Lane->_Sleeping.store(false, std::memory_order_relaxed);
+                if (_Lane->_Queue.empty() && _My_lanes_stopping.load()) {
+                    break;
+                }
+            }
+        }
+
+        // 处理一条消息：先交给原始消息回调，未处理时裁剪消息代码并交给编码消息回调
+        // 参数：m - 消息对象
+        void _Dispatch_msg(Msg& m) {
             if (!_On_raw_message(m)) {
                 auto code = Msg::_Chop_msg_code(m);
                 _On_message(code, m);
             }
         }
+
+    private:
+        std::vector<std::unique_ptr<LANE>> _My_lanes;   // 按键保序分发的工作通道，为空表示未开启
+        std::atomic<bool> _My_lanes_stopping{ false };
+        size_t _My_batch_count = 0;             // 每批最多消息数，小于等于 1 表示关闭批量分发
+        size_t _My_batch_bytes = 0;             // 每批最多字节数，0 表示不限
+        nng_duration _My_batch_time = 0;        // 每批最多继续接收的时间（毫秒），0 表示不限
+        bool _My_unpack = false;                // 是否拆分发送方合并的消息
     };
 
     // DispatcherWithReturn 类：带返回的消息分发器，继承 Dispatcher 和 Socket
@@ -76,14 +411,21 @@ namespace nng
     class DispatcherWithReturn : public Dispatcher
     {
     protected:
-        virtual void _On_recv(Msg& m) noexcept override {
+        virtual bool _On_recv(Msg& m, const Ctx* ctx) noexcept override {
             if (!_On_raw_message(m)) {
                 auto code = Msg::_Chop_msg_code(m);
                 auto result = _On_message(code, m);
                 Msg::_Append_msg_result(m, result);
             }
 
-            send(std::move(m));
+            // 回复须在接收所在的上下文上发送
+            if (ctx) {
+                ctx->send(std::move(m));
+            }
+            else {
+                send(std::move(m));
+            }
+            return false;
         }
     };
 }
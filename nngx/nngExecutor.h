@@ -0,0 +1,235 @@
+#pragma once
+
+#include <mutex>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <condition_variable>
+
+#include "nngException.h"
+#include "nngInplaceFunction.h"
+
+namespace nng
+{
+    // Executor 类：执行器接口
+    // 用途：ServiceAio、ContextParallel 等把消息处理回调从 nng 的 aio 回调线程转交给执行器运行
+    // 特性：
+    // - 任务为 InplaceFunction，投递时不分配堆内存
+    // - 可由使用者实现以接入自己的线程池，也可直接使用 ThreadPool
+    class Executor
+    {
+    public:
+        using Task = InplaceFunction<void()>;
+
+        // 析构函数
+        virtual ~Executor() = default;
+
+        // 投递任务
+        // 参数：task - 要执行的任务，成功时被移走
+        // 返回：操作结果，0 表示成功；失败时任务未被接收，由调用方自行执行
+        // 说明：接收的任务必须被执行（包括停止时已排队的任务），ServiceAio、ContextParallel 停止时等待它们结束
+        virtual int post(Task&& task) noexcept = 0;
+
+        // 检查当前线程是否为执行器的工作线程
+        // 返回：true 表示是；默认返回 false
+        // 说明：ServiceAio、ContextParallel 据此拒绝在工作线程中等待处理回调结束（等待自身会死锁）
+        virtual bool in_worker() const noexcept {
+            return false;
+        }
+    };
+
+    // ThreadPool 类：工作窃取线程池
+    // 用途：运行耗 CPU 的消息处理回调，使 nng 的 aio 回调线程只负责 I/O 完成
+    // 特性：
+    // - 每个工作线程有自己的任务队列：线程内投递的任务放入自身队列尾部并由其优先以 LIFO 取出
+    // - 外部线程投递的任务按轮转分配到各工作线程的队列
+    // - 工作线程自身队列为空时从其它队列头部窃取任务，全部为空时休眠
+    // - stop 时执行完已投递的任务再退出
+    class ThreadPool : public Executor
+    {
+        typedef struct alignas(64) _WORKER
+        {
+            std::mutex _Mtx;
+            std::deque<Task> _Tasks;
+        } WORKER, * PWORKER;
+
+    public:
+        // 构造函数：创建线程池（未启动）
+        ThreadPool() noexcept = default;
+
+        // 构造函数：创建并启动线程池
+        // 参数：threads - 工作线程数，0 表示硬件并发数
+        // 异常：若创建线程失败，抛出 std::system_error
+        explicit ThreadPool(size_t threads) noexcept(false) {
+            start(threads);
+        }
+
+        // 析构函数：执行完已投递的任务后停止
+        virtual ~ThreadPool() {
+            stop();
+        }
+
+        // 禁用拷贝构造函数
+        ThreadPool(const ThreadPool&) = delete;
+
+        // 禁用拷贝赋值运算符
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // 启动线程池
+        // 参数：threads - 工作线程数，0 表示硬件并发数
+        // 返回：操作结果，0 表示成功；NNG_EBUSY 表示已经启动
+        // 异常：若创建线程失败，抛出 std::system_error
+        int start(size_t threads = 0) noexcept(false) {
+            if (!_My_threads.empty()) {
+                return NNG_EBUSY;
+            }
+            if (threads == 0) {
+                threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+            }
+
+            _My_stopping.store(false);
+            _My_workers = std::make_unique<WORKER[]>(threads);
+            _My_worker_count = threads;
+            for (size_t i = 0; i < threads; ++i) {
+                _My_threads.emplace_back(&ThreadPool::_Run, this, i);
+            }
+            return NNG_OK;
+        }
+
+        // 停止线程池：执行完已投递的任务后等待全部工作线程退出
+        // 说明：不能在工作线程中调用
+        void stop() noexcept {
+            if (_My_threads.empty()) {
+                return;
+            }
+
+            {
+                std::scoped_lock locker(_My_sleep_mtx);
+                _My_stopping.store(true);
+            }
+            _My_sleep_cv.notify_all();
+
+            for (auto& _Thread : _My_threads) {
+                _Thread.join();
+            }
+            _My_threads.clear();
+            _My_workers.reset();
+            _My_worker_count = 0;
+        }
+
+        // 投递任务
+        // 参数：task - 要执行的任务，成功时被移走
+        // 返回：操作结果，0 表示成功；NNG_ECLOSED 表示线程池未启动或正在停止
+        virtual int post(Task&& task) noexcept override {
+            {
+                // 与工作线程的退出判断互斥：停止后不再接收任务
+                std::scoped_lock locker(_My_sleep_mtx);
+                if (_My_stopping.load() || _My_worker_count == 0) {
+                    return NNG_ECLOSED;
+                }
+                _My_pending.fetch_add(1);
+            }
+
+            // 工作线程内投递放入自身队列，否则轮转分配
+            size_t _Idx = _Tls_owner == this ? _Tls_index : _My_next.fetch_add(1, std::memory_order_relaxed) % _My_worker_count;
+            try {
+                std::scoped_lock locker(_My_workers[_Idx]._Mtx);
+                _My_workers[_Idx]._Tasks.push_back(std::move(task));
+            }
+            catch (const std::bad_alloc&) {
+                _My_pending.fetch_sub(1);
+                return NNG_ENOMEM;
+            }
+            _My_sleep_cv.notify_one();
+            return NNG_OK;
+        }
+
+        // 检查当前线程是否为本线程池的工作线程
+        // 返回：true 表示是
+        virtual bool in_worker() const noexcept override {
+            return _Tls_owner == this;
+        }
+
+        // 获取工作线程数
+        // 返回：工作线程数，未启动时为 0
+        size_t size() const noexcept {
+            return _My_worker_count;
+        }
+
+        // 获取已投递但尚未开始执行的任务数
+        // 返回：任务数
+        size_t pending() const noexcept {
+            return _My_pending.load();
+        }
+
+    private:
+        // 取出一个任务：先取自身队列尾部，再从其它队列头部窃取
+        // 参数：idx - 工作线程序号，task - 存储取出的任务
+        // 返回：true 表示取到任务
+        bool _Take(size_t idx, Task& task) noexcept {
+            {
+                auto& _Worker = _My_workers[idx];
+                std::scoped_lock locker(_Worker._Mtx);
+                if (!_Worker._Tasks.empty()) {
+                    task = std::move(_Worker._Tasks.back());
+                    _Worker._Tasks.pop_back();
+                    return true;
+                }
+            }
+
+            for (size_t i = 1; i < _My_worker_count; ++i) {
+                auto& _Victim = _My_workers[(idx + i) % _My_worker_count];
+                std::scoped_lock locker(_Victim._Mtx);
+                if (!_Victim._Tasks.empty()) {
+                    task = std::move(_Victim._Tasks.front());
+                    _Victim._Tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // 工作线程主循环
+        // 参数：idx - 工作线程序号
+        void _Run(size_t idx) noexcept {
+            _Tls_owner = this;
+            _Tls_index = idx;
+
+            Task _Task;
+            for (;;) {
+                if (_Take(idx, _Task)) {
+                    _My_pending.fetch_sub(1);
+                    _Task();
+                    _Task = nullptr;
+                    continue;
+                }
+
+                std::unique_lock locker(_My_sleep_mtx);
+                if (_My_pending.load() == 0) {
+                    if (_My_stopping.load()) {
+                        break;
+                    }
+                    _My_sleep_cv.wait(locker, [this] { return _My_pending.load() != 0 || _My_stopping.load(); });
+                }
+            }
+
+            _Tls_owner = nullptr;
+        }
+
+    private:
+        std::unique_ptr<WORKER[]> _My_workers;
+        size_t _My_worker_count = 0;
+        std::vector<std::thread> _My_threads;
+        std::atomic<size_t> _My_next{ 0 };          // 外部投递的轮转序号
+        std::atomic<size_t> _My_pending{ 0 };       // 已投递但尚未取出的任务数，入队前即计入
+        std::atomic<bool> _My_stopping{ false };
+        std::mutex _My_sleep_mtx;                   // 与 _My_sleep_cv 配合，避免休眠时丢失唤醒
+        std::condition_variable _My_sleep_cv;
+
+        static inline thread_local ThreadPool* _Tls_owner = nullptr;   // 当前线程所属的线程池
+        static inline thread_local size_t _Tls_index = 0;              // 当前线程在所属线程池中的序号
+    };
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "nngException.h"
+
+namespace nng
+{
+    template <typename _Sig_t, size_t _Capacity = 48>
+    class InplaceFunction;
+
+    // InplaceFunction 类：使用内联存储的可调用对象包装类（std::function 的无堆分配替代）
+    // 用途：在高频路径（如每个请求的完成回调）上保存小型可调用对象，避免逐次堆分配
+    // 特性：
+    // - 可调用对象直接存放在对象内部的固定缓冲区中，永不分配堆内存
+    // - 可调用对象超过缓冲区大小、对齐要求过高或移动构造可能抛异常时，编译期报错
+    // - 仅支持移动，禁用拷贝
+    template <typename _Ret_t, typename... _Args_t, size_t _Capacity>
+    class InplaceFunction<_Ret_t(_Args_t...), _Capacity>
+    {
+        enum _OPERATION { OP_MOVE, OP_DESTROY };
+        using _Invoke_t = _Ret_t(*)(void*, _Args_t&&...);
+        using _Manage_t = void (*)(_OPERATION, void*, void*) noexcept;
+
+    public:
+        // 构造函数：创建空的可调用对象
+        InplaceFunction() noexcept = default;
+
+        // 构造函数：创建空的可调用对象
+        InplaceFunction(std::nullptr_t) noexcept {}
+
+        // 构造函数：保存可调用对象
+        // 参数：fn - 可调用对象，被移动（或拷贝）到内联存储中
+        template <typename _Fn_t, typename _Decay_t = std::decay_t<_Fn_t>>
+            requires (!std::is_same_v<_Decay_t, InplaceFunction> && std::is_invocable_r_v<_Ret_t, _Decay_t&, _Args_t...>)
+        InplaceFunction(_Fn_t&& fn) noexcept(std::is_nothrow_constructible_v<_Decay_t, _Fn_t&&>) {
+            static_assert(sizeof(_Decay_t) <= _Capacity, "InplaceFunction: callable is too large for the inline storage");
+            static_assert(alignof(_Decay_t) <= alignof(std::max_align_t), "InplaceFunction: callable is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<_Decay_t>, "InplaceFunction: callable must be nothrow move constructible");
+
+            ::new (static_cast<void*>(_My_storage)) _Decay_t(std::forward<_Fn_t>(fn));
+            _My_invoke = [](void* _Obj, _Args_t&&... _Args) -> _Ret_t {
+                return (*static_cast<_Decay_t*>(_Obj))(std::forward<_Args_t>(_Args)...);
+            };
+            _My_manage = [](_OPERATION _Op, void* _Dst, void* _Src) noexcept {
+                if (_Op == OP_MOVE) {
+                    ::new (_Dst) _Decay_t(std::move(*static_cast<_Decay_t*>(_Src)));
+                }
+                static_cast<_Decay_t*>(_Src)->~_Decay_t();
+            };
+        }
+
+        // 析构函数：销毁保存的可调用对象
+        ~InplaceFunction() noexcept {
+            reset();
+        }
+
+        // 禁用拷贝构造函数
+        InplaceFunction(const InplaceFunction&) = delete;
+
+        // 禁用拷贝赋值运算符
+        InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+        // 移动构造函数：转移可调用对象
+        // 参数：other - 源对象，移动后为空
+        InplaceFunction(InplaceFunction&& other) noexcept {
+            _Move_from(other);
+        }
+
+        // 移动赋值运算符：转移可调用对象
+        // 参数：other - 源对象，移动后为空
+        // 返回：当前对象的引用
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+                _Move_from(other);
+            }
+            return *this;
+        }
+
+        // 赋空：销毁保存的可调用对象
+        // 返回：当前对象的引用
+        InplaceFunction& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        // 调用保存的可调用对象
+        // 参数：args - 调用参数
+        // 返回：可调用对象的返回值
+        // 说明：对象为空时调用属于未定义行为（调试版本断言）
+        _Ret_t operator()(_Args_t... args) const {
+            assert(_My_invoke);
+            return _My_invoke(const_cast<unsigned char*>(_My_storage), std::forward<_Args_t>(args)...);
+        }
+
+        // 销毁保存的可调用对象，之后对象为空
+        void reset() noexcept {
+            if (_My_manage) {
+                _My_manage(OP_DESTROY, nullptr, _My_storage);
+                _My_manage = nullptr;
+                _My_invoke = nullptr;
+            }
+        }
+
+        // 检查是否保存了可调用对象
+        // 返回：true 表示非空
+        explicit operator bool() const noexcept {
+            return _My_invoke != nullptr;
+        }
+
+    private:
+        // 从源对象转移可调用对象（当前对象须为空）
+        // 参数：other - 源对象，转移后为空
+        void _Move_from(InplaceFunction& other) noexcept {
+            if (other._My_manage) {
+                other._My_manage(OP_MOVE, _My_storage, other._My_storage);
+                _My_invoke = std::exchange(other._My_invoke, nullptr);
+                _My_manage = std::exchange(other._My_manage, nullptr);
+            }
+        }
+
+    private:
+        alignas(std::max_align_t) unsigned char _My_storage[_Capacity];
+        _Invoke_t _My_invoke = nullptr;
+        _Manage_t _My_manage = nullptr;
+    };
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <span>
 #include <cstring>
 
 #include "nngException.h"
+#include "nngMsgPool.h"
+#include "nngPod.h"
 
 namespace nng
 {
@@ -13,7 +16,10 @@ namespace nng
     // - 支持移动构造和移动赋值，禁用拷贝以保证资源独占
     // - 提供对消息头部和正文的追加、插入、裁剪等操作
     // - 支持无符号整数和字符串的便捷操作
+    // - 支持按 Pod / Schema 一次编解码整个结构体（*_pod）
+    // - 支持整数数组的批量编解码（*_array），字节序转换使用 SIMD
     // - 异常安全：分配失败或操作错误时抛出 Exception
+    // - MsgPool 开启时经由回收池分配和释放 nng_msg
     class Msg
     {
     public:
@@ -30,7 +36,7 @@ namespace nng
             std::enable_if_t<std::is_integral_v<T>, int> = 0
         >
         explicit Msg(T size) noexcept(false) {
-            int rv = nng_msg_alloc(&_My_msg, (size_t)size);
+            int rv = _Alloc_msg(&_My_msg, (size_t)size);
             if (rv != NNG_OK) {
                 throw Exception(rv, "nng_msg_alloc");
             }
@@ -40,7 +46,7 @@ namespace nng
         // 参数：data - 数据指针，data_size - 数据大小
         // 异常：若分配失败，抛出 Exception
         explicit Msg(const void* data, size_t data_size) noexcept(false) {
-            int rv = nng_msg_alloc(&_My_msg, data_size);
+            int rv = _Alloc_msg(&_My_msg, data_size);
             if (rv != NNG_OK) {
                 throw Exception(rv, "nng_msg_alloc");
             }
@@ -51,7 +57,7 @@ namespace nng
         // 参数：iov - 包含数据缓冲区和长度的 nng_iov 结构
         // 异常：若分配失败，抛出 Exception
         explicit Msg(const nng_iov& iov) noexcept(false) {
-            int rv = nng_msg_alloc(&_My_msg, iov.iov_len);
+            int rv = _Alloc_msg(&_My_msg, iov.iov_len);
             if (rv != NNG_OK) {
                 throw Exception(rv, "nng_msg_alloc");
             }
@@ -61,7 +67,7 @@ namespace nng
         // 析构函数：释放消息资源
         ~Msg() noexcept {
             if (_My_msg) {
-                nng_msg_free(_My_msg);
+                _Free_msg(_My_msg);
             }
         }
 
@@ -77,7 +83,7 @@ namespace nng
         Msg& operator=(Msg&& other) noexcept {
             if (this != &other) {
                 if (_My_msg) {
-                    nng_msg_free(_My_msg);
+                    _Free_msg(_My_msg);
                 }
                 _My_msg = other._My_msg;
                 other._My_msg = nullptr;
@@ -97,7 +103,7 @@ namespace nng
         // 异常：可能抛出分配失败的异常
         int realloc(size_t size) noexcept {
             if (_My_msg == nullptr) {
-                return nng_msg_alloc(&_My_msg, size);
+                return _Alloc_msg(&_My_msg, size);
             }
             else {
                 return nng_msg_realloc(_My_msg, size);
@@ -635,6 +641,118 @@ namespace nng
             return s;
         }
 
+        // 向消息正文追加结构体（按 Pod<T> 编码，正文只扩展一次并原地编码）
+        // 参数：val - 要追加的结构体
+        // 返回：操作结果，0 表示成功
+        template <typename T>
+        int append_pod(const T& val) noexcept {
+            size_t _Len = _My_msg ? len() : 0;
+            int rv = realloc(_Len + Pod<T>::size);
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            Pod<T>::encode(static_cast<uint8_t*>(body()) + _Len, val);
+            return NNG_OK;
+        }
+
+        // 在消息正文开头插入结构体（按 Pod<T> 编码）
+        // 参数：val - 要插入的结构体
+        // 返回：操作结果，0 表示成功
+        template <typename T>
+        int insert_pod(const T& val) noexcept {
+            std::array<uint8_t, Pod<T>::size> _Buf;
+            Pod<T>::encode(_Buf.data(), val);
+            return nng_msg_insert(_My_msg, _Buf.data(), _Buf.size());
+        }
+
+        // 从消息正文末尾裁剪结构体（按 Pod<T> 解码）
+        // 参数：val - 存储裁剪出的结构体
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int chop_pod(T* val) noexcept {
+            if (len() < Pod<T>::size) {
+                return NNG_EINVAL;
+            }
+            Pod<T>::decode(body_tail(Pod<T>::size), *val);
+            return nng_msg_chop(_My_msg, Pod<T>::size);
+        }
+
+        // 从消息正文末尾裁剪结构体（按 Pod<T> 解码）
+        // 返回：裁剪出的结构体
+        // 异常：若操作失败，抛出 Exception
+        template <typename T>
+        T chop_pod() noexcept(false) {
+            T v{};
+            int rv = chop_pod(&v);
+            if (rv != NNG_OK) {
+                throw Exception(rv, "chop_pod");
+            }
+            return v;
+        }
+
+        // 从消息正文开头裁剪结构体（按 Pod<T> 解码）
+        // 参数：val - 存储裁剪出的结构体
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int trim_pod(T* val) noexcept {
+            if (len() < Pod<T>::size) {
+                return NNG_EINVAL;
+            }
+            Pod<T>::decode(body(), *val);
+            return nng_msg_trim(_My_msg, Pod<T>::size);
+        }
+
+        // 从消息正文开头裁剪结构体（按 Pod<T> 解码）
+        // 返回：裁剪出的结构体
+        // 异常：若操作失败，抛出 Exception
+        template <typename T>
+        T trim_pod() noexcept(false) {
+            T v{};
+            int rv = trim_pod(&v);
+            if (rv != NNG_OK) {
+                throw Exception(rv, "trim_pod");
+            }
+            return v;
+        }
+
+        // 向消息正文追加整数数组（正文只扩展一次，不写入元素个数）
+        // 参数：vals - 要追加的数组；order - FO_NETWORK 逐个元素转为网络字节序，FO_NATIVE 原样复制
+        // 返回：操作结果，0 表示成功
+        template <typename T>
+        int append_array(std::span<const T> vals, FIELD_ORDER order = FO_NETWORK) noexcept {
+            size_t _Len = _My_msg ? len() : 0;
+            int rv = realloc(_Len + vals.size_bytes());
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            ByteOrder::copy<T>(static_cast<uint8_t*>(body()) + _Len, vals.data(), vals.size(), order);
+            return NNG_OK;
+        }
+
+        // 从消息正文开头裁剪整数数组
+        // 参数：vals - 存储裁剪出的数组，元素个数即要读取的个数；order - 与追加时相同的字节序策略
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int trim_array(std::span<T> vals, FIELD_ORDER order = FO_NETWORK) noexcept {
+            if (len() < vals.size_bytes()) {
+                return NNG_EINVAL;
+            }
+            ByteOrder::copy<T>(vals.data(), body(), vals.size(), order);
+            return nng_msg_trim(_My_msg, vals.size_bytes());
+        }
+
+        // 从消息正文末尾裁剪整数数组
+        // 参数：vals - 存储裁剪出的数组，元素个数即要读取的个数；order - 与追加时相同的字节序策略
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int chop_array(std::span<T> vals, FIELD_ORDER order = FO_NETWORK) noexcept {
+            if (len() < vals.size_bytes()) {
+                return NNG_EINVAL;
+            }
+            ByteOrder::copy<T>(vals.data(), body_tail(vals.size_bytes()), vals.size(), order);
+            return nng_msg_chop(_My_msg, vals.size_bytes());
+        }
+
         // 复制消息到目标消息对象
         // 参数：dest - 目标消息对象
         // 返回：操作结果，0 表示成功
@@ -643,7 +761,7 @@ namespace nng
             int rv = nng_msg_dup(&new_msg, _My_msg);
             if (rv == NNG_OK) {
                 if (dest->_My_msg) {
-                    nng_msg_free(dest->_My_msg);
+                    _Free_msg(dest->_My_msg);
                 }
                 dest->_My_msg = new_msg;
             }
@@ -678,7 +796,7 @@ namespace nng
         Msg& operator =(nng_msg* msg) noexcept {
             if (_My_msg != msg) {
                 if (_My_msg) {
-                    nng_msg_free(_My_msg);
+                    _Free_msg(_My_msg);
                 }
                 _My_msg = msg;
             }
@@ -737,6 +855,88 @@ namespace nng
             m.append_u64(result);
         }
 
+        // 合并消息的消息代码：由 AsyncSenderNoReturn::set_coalesce 产生，正文为若干 [u32 长度][内部消息正文] 帧
+        // 说明：内部消息正文保留各自的消息代码，应用程序不应使用该消息代码
+        static constexpr _Ty_msg_code _MSG_CODE_PACKED = 0xFFFFFFFFFFFF0C0Aull;
+
+        // 检查消息是否为合并消息（不修改消息）
+        // 参数：m - 消息对象
+        // 返回：true 表示消息末尾为合并消息代码
+        static inline bool _Is_packed_msg(const Msg& m) noexcept {
+            if (!m || m.len() < sizeof(_Ty_msg_code)) {
+                return false;
+            }
+
+            auto _Tail = (const uint8_t*)m.body() + m.len() - sizeof(_Ty_msg_code);
+            _Ty_msg_code _Code = 0;
+            for (size_t i = 0; i < sizeof(_Ty_msg_code); ++i) {
+                _Code = (_Code << 8) | _Tail[i];
+            }
+            return _Code == _MSG_CODE_PACKED;
+        }
+
+        // 向合并消息追加一条内部消息（合并消息代码由调用方最后追加）
+        // 参数：packed - 合并消息，inner - 内部消息
+        // 返回：操作结果，0 表示成功
+        static inline int _Pack_msg(Msg& packed, const Msg& inner) noexcept {
+            int rv = packed.append_u32((uint32_t)inner.len());
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            return packed.append(inner.body(), inner.len());
+        }
+
+        // 拆分合并消息，逐条以内部消息调用回调
+        // 参数：packed - 合并消息（含合并消息代码），fn - 回调，以 Msg& 调用，内部消息与发送时的消息相同
+        // 返回：操作结果，0 表示成功；NNG_EPROTO 表示帧格式错误，此时整条合并消息被丢弃，不调用回调；
+        //       其它错误码表示分配失败，之前的内部消息已交给回调
+        // 异常：自身不抛出异常，回调抛出的异常原样传出
+        // 说明：先校验全部帧再逐条回调；所有内部消息复用同一个 Msg 对象，回调可以移走它
+        template <typename _Fn_t>
+        static nng_err _Unpack_msg(Msg& packed, _Fn_t&& fn) noexcept(false) {
+            _Chop_msg_code(packed);
+
+            auto _Read_len = [](const uint8_t* _Ptr) {
+                return ((size_t)_Ptr[0] << 24) | ((size_t)_Ptr[1] << 16) | ((size_t)_Ptr[2] << 8) | (size_t)_Ptr[3];
+            };
+
+            // 校验帧格式，格式错误时不交出任何内部消息
+            auto _Data = (const uint8_t*)packed.body();
+            size_t _Remain = packed.len();
+            while (_Remain != 0) {
+                if (_Remain < sizeof(uint32_t)) {
+                    return NNG_EPROTO;
+                }
+                size_t _Len = _Read_len(_Data);
+                _Data += sizeof(uint32_t);
+                _Remain -= sizeof(uint32_t);
+                if (_Len > _Remain) {
+                    return NNG_EPROTO;
+                }
+                _Data += _Len;
+                _Remain -= _Len;
+            }
+
+            _Data = (const uint8_t*)packed.body();
+            _Remain = packed.len();
+            Msg _Inner;
+            while (_Remain != 0) {
+                size_t _Len = _Read_len(_Data);
+                _Data += sizeof(uint32_t);
+                _Remain -= sizeof(uint32_t);
+
+                int rv = _Inner.realloc(_Len);
+                if (rv != NNG_OK) {
+                    return rv;
+                }
+                std::memcpy(_Inner.body(), _Data, _Len);
+                _Data += _Len;
+                _Remain -= _Len;
+                fn(_Inner);
+            }
+            return NNG_OK;
+        }
+
     public:
         inline static Msg to_msg(std::string_view sv) noexcept(false) {
             return Msg(sv.data(), sv.size());
@@ -745,6 +945,25 @@ namespace nng
         inline static std::string to_string(const Msg& m) {
             return std::string((const char*)m.body(), m.len());
         }
+    private:
+        // 分配 nng_msg：MsgPool 开启时从回收池取出
+        // 参数：msg - 存储消息指针，size - 消息正文长度
+        // 返回：操作结果，0 表示成功
+        static int _Alloc_msg(nng_msg** msg, size_t size) noexcept {
+            return MsgPool::enabled() ? MsgPool::alloc(msg, size) : nng_msg_alloc(msg, size);
+        }
+
+        // 释放 nng_msg：MsgPool 开启时归还回收池
+        // 参数：msg - 消息指针
+        static void _Free_msg(nng_msg* msg) noexcept {
+            if (MsgPool::enabled()) {
+                MsgPool::free(msg);
+            }
+            else {
+                nng_msg_free(msg);
+            }
+        }
+
     private:
         nng_msg* _My_msg = nullptr;
     };
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <bit>
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+#include "nngException.h"
+
+namespace nng
+{
+    // MsgPool 类：nng_msg 回收池（进程级）
+    // 用途：在高频收发路径上复用 nng_msg，消除 nng_msg_alloc / nng_msg_free
+    // 特性：
+    // - 按容量分为 64 字节到 16 KB 的 9 个大小等级，每个等级的消息容量不小于等级大小
+    // - 每个线程有自己的缓存，命中时不加锁；线程缓存空或满时与全局列表成批交换
+    // - 开启后 Msg 的构造、realloc 和析构经由回收池，分发循环中销毁的接收消息同样回收
+    // - 取出的消息已清空正文和头部、重置管道，长度为请求的大小
+    // - 默认关闭，关闭时 Msg 的行为与直接调用 nng_msg_alloc / nng_msg_free 相同
+    class MsgPool
+    {
+        enum
+        {
+            _MIN_SHIFT = 6,                 // 最小等级 64 字节
+            _CLASS_COUNT = 9,               // 64 字节到 16 KB
+            _CACHE_LIMIT = 64,              // 每个线程每个等级最多缓存的消息数
+            _CENTRAL_LIMIT = 1024,          // 每个等级全局列表最多保存的消息数
+            _BATCH = _CACHE_LIMIT / 2       // 线程缓存与全局列表每次交换的消息数
+        };
+
+        static constexpr size_t _Class_size(size_t c) noexcept {
+            return (size_t)1 << (c + _MIN_SHIFT);
+        }
+
+        // 全局列表：线程缓存溢出和补充时使用
+        typedef struct _CENTRAL
+        {
+            std::mutex _Mtx;
+            std::vector<nng_msg*> _Msgs;
+        } CENTRAL, * PCENTRAL;
+
+        // 线程缓存：线程退出时释放缓存的消息
+        typedef struct _CACHE
+        {
+            std::vector<nng_msg*> _Msgs[_CLASS_COUNT];
+
+            // 预留空间，之后缓存不再分配；预留失败时该等级容量为 0，消息不经缓存直接分配和释放
+            _CACHE() noexcept {
+                for (auto& _List : _Msgs) {
+                    try {
+                        _List.reserve(_CACHE_LIMIT);
+                    }
+                    catch (const std::bad_alloc&) {
+                    }
+                }
+            }
+
+            ~_CACHE() noexcept {
+                for (auto& _List : _Msgs) {
+                    for (auto _Msg : _List) {
+                        nng_msg_free(_Msg);
+                    }
+                }
+            }
+        } CACHE, * PCACHE;
+
+    public:
+        // 回收池计数
+        typedef struct _STATS
+        {
+            uint64_t _Hits;         // 从池中取出的次数
+            uint64_t _Misses;       // 池中没有合适的消息而新分配的次数
+            uint64_t _Recycled;     // 归还到池中的次数
+            uint64_t _Released;     // 因不适合回收或池已满而释放的次数
+        } STATS, * PSTATS;
+
+        // 开启或关闭回收池
+        // 参数：on - true 开启，false 关闭
+        // 说明：关闭后已缓存的消息保留到 trim 或线程退出；关闭前取出的消息照常释放
+        static void enable(bool on = true) noexcept {
+            _My_enabled.store(on, std::memory_order_relaxed);
+        }
+
+        // 检查回收池是否开启
+        // 返回：true 表示开启
+        static bool enabled() noexcept {
+            return _My_enabled.load(std::memory_order_relaxed);
+        }
+
+        // 取出一条消息
+        // 参数：msg - 存储消息指针，size - 消息正文长度
+        // 返回：操作结果，0 表示成功
+        static int alloc(nng_msg** msg, size_t size) noexcept {
+            if (size > _Class_size(_CLASS_COUNT - 1)) {
+                _My_misses.fetch_add(1, std::memory_order_relaxed);
+                return nng_msg_alloc(msg, size);
+            }
+
+            size_t _Class = size <= _Class_size(0) ? 0 : (size_t)std::bit_width(size - 1) - _MIN_SHIFT;
+            auto& _List = _Cache()._Msgs[_Class];
+            if (_List.empty()) {
+                _Refill(_Class, _List);
+            }
+
+            if (!_List.empty()) {
+                nng_msg* _Msg = _List.back();
+                _List.pop_back();
+                nng_msg_clear(_Msg);
+                nng_msg_header_clear(_Msg);
+                nng_msg_set_pipe(_Msg, nng_pipe{});
+                // 容量不小于等级大小，不会重新分配
+                int rv = nng_msg_realloc(_Msg, size);
+                if (rv != NNG_OK) {
+                    nng_msg_free(_Msg);
+                    return rv;
+                }
+                _My_hits.fetch_add(1, std::memory_order_relaxed);
+                *msg = _Msg;
+                return NNG_OK;
+            }
+
+            // 按等级大小分配，归还后可满足同等级的任意请求
+            _My_misses.fetch_add(1, std::memory_order_relaxed);
+            nng_msg* _Msg = nullptr;
+            int rv = nng_msg_alloc(&_Msg, _Class_size(_Class));
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            rv = nng_msg_realloc(_Msg, size);
+            if (rv != NNG_OK) {
+                nng_msg_free(_Msg);
+                return rv;
+            }
+            *msg = _Msg;
+            return NNG_OK;
+        }
+
+        // 归还一条消息
+        // 参数：msg - 消息指针，容量不在等级范围内或池已满时直接释放
+        static void free(nng_msg* msg) noexcept {
+            size_t _Capacity = nng_msg_capacity(msg);
+            if (_Capacity < _Class_size(0) || _Capacity > _Class_size(_CLASS_COUNT - 1) * 2) {
+                _My_released.fetch_add(1, std::memory_order_relaxed);
+                nng_msg_free(msg);
+                return;
+            }
+
+            size_t _Class = (std::min)((size_t)std::bit_width(_Capacity) - 1 - _MIN_SHIFT, (size_t)_CLASS_COUNT - 1);
+            auto& _List = _Cache()._Msgs[_Class];
+            if (_List.size() >= _CACHE_LIMIT) {
+                _Spill(_Class, _List);
+            }
+            // 线程缓存预留失败时不缓存，避免 push_back 分配
+            if (_List.size() >= _List.capacity()) {
+                _My_released.fetch_add(1, std::memory_order_relaxed);
+                nng_msg_free(msg);
+                return;
+            }
+            _List.push_back(msg);
+            _My_recycled.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 获取回收池计数
+        // 返回：计数快照
+        static STATS stats() noexcept {
+            return {
+                _My_hits.load(std::memory_order_relaxed),
+                _My_misses.load(std::memory_order_relaxed),
+                _My_recycled.load(std::memory_order_relaxed),
+                _My_released.load(std::memory_order_relaxed)
+            };
+        }
+
+        // 清零回收池计数
+        static void reset_stats() noexcept {
+            _My_hits.store(0, std::memory_order_relaxed);
+            _My_misses.store(0, std::memory_order_relaxed);
+            _My_recycled.store(0, std::memory_order_relaxed);
+            _My_released.store(0, std::memory_order_relaxed);
+        }
+
+        // 释放全局列表和当前线程缓存中的全部消息
+        // 说明：其它线程的缓存在线程退出时释放
+        static void trim() noexcept {
+            auto& _Cache_ref = _Cache();
+            for (size_t c = 0; c < _CLASS_COUNT; ++c) {
+                for (auto _Msg : _Cache_ref._Msgs[c]) {
+                    nng_msg_free(_Msg);
+                }
+                _Cache_ref._Msgs[c].clear();
+
+                std::scoped_lock locker(_My_central[c]._Mtx);
+                for (auto _Msg : _My_central[c]._Msgs) {
+                    nng_msg_free(_Msg);
+                }
+                _My_central[c]._Msgs.clear();
+            }
+        }
+
+    private:
+        // 获取当前线程的缓存
+        // 返回：线程缓存
+        static CACHE& _Cache() noexcept {
+            thread_local CACHE _Tls_cache;
+            return _Tls_cache;
+        }
+
+        // 从全局列表补充线程缓存
+        // 参数：c - 等级，list - 线程缓存中该等级的列表
+        static void _Refill(size_t c, std::vector<nng_msg*>& list) noexcept {
+            auto& _Central = _My_central[c];
+            std::scoped_lock locker(_Central._Mtx);
+            size_t _Count = (std::min)({ _Central._Msgs.size(), (size_t)_BATCH, list.capacity() - list.size() });
+            list.insert(list.end(), _Central._Msgs.end() - _Count, _Central._Msgs.end());
+            _Central._Msgs.resize(_Central._Msgs.size() - _Count);
+        }
+
+        // 线程缓存已满时把一半移到全局列表，全局列表已满的部分直接释放
+        // 参数：c - 等级，list - 线程缓存中该等级的列表
+        static void _Spill(size_t c, std::vector<nng_msg*>& list) noexcept {
+            auto& _Central = _My_central[c];
+            size_t _Moved = 0;
+            {
+                std::scoped_lock locker(_Central._Mtx);
+                if (_Central._Msgs.capacity() == 0) {
+                    try {
+                        _Central._Msgs.reserve(_CENTRAL_LIMIT);
+                    }
+                    catch (const std::bad_alloc&) {
+                    }
+                }
+                while (_Moved < _BATCH && _Central._Msgs.size() < _Central._Msgs.capacity() && _Central._Msgs.size() < _CENTRAL_LIMIT) {
+                    _Central._Msgs.push_back(list.back());
+                    list.pop_back();
+                    ++_Moved;
+                }
+            }
+            for (; _Moved < _BATCH; ++_Moved) {
+                _My_released.fetch_add(1, std::memory_order_relaxed);
+                nng_msg_free(list.back());
+                list.pop_back();
+            }
+        }
+
+    private:
+        static inline std::atomic<bool> _My_enabled{ false };
+        static inline CENTRAL _My_central[_CLASS_COUNT];
+        static inline std::atomic<uint64_t> _My_hits{ 0 };
+        static inline std::atomic<uint64_t> _My_misses{ 0 };
+        static inline std::atomic<uint64_t> _My_recycled{ 0 };
+        static inline std::atomic<uint64_t> _My_released{ 0 };
+    };
+}
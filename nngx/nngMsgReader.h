@@ -0,0 +1,255 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "nngException.h"
+#include "nngMsg.h"
+
+namespace nng
+{
+    // MsgReader 类：消息正文的只读游标
+    // 用途：在只读的处理回调中解析消息，替代逐个字段修改 nng_msg 的 Msg::trim_* / chop_*
+    // 特性：
+    // - 不修改消息：游标在正文的开头和末尾之间移动，trim_* 从开头读取，chop_* 从末尾读取，格式与 Msg 的同名函数一致
+    // - 字符串和字节序列以 std::string_view / std::span 返回，借用消息的内存，不复制、不分配
+    // - 每次读取都检查边界，长度不足时返回 NNG_EINVAL 且游标不动
+    // - 借用的结果和游标本身都不得比消息存活更久，消息被修改后失效
+    class MsgReader
+    {
+    public:
+        // 构造函数：在消息正文上创建游标
+        // 参数：msg - 消息对象
+        explicit MsgReader(const Msg& msg) noexcept
+            : MsgReader(msg.body(), msg.len()) {
+        }
+
+        // 构造函数：在一段内存上创建游标
+        // 参数：data - 数据指针，size - 数据大小
+        MsgReader(const void* data, size_t size) noexcept
+            : _My_begin(static_cast<const std::byte*>(data)), _My_end(static_cast<const std::byte*>(data) + size) {
+        }
+
+        // 从开头读取 16 位无符号整数（网络字节序）
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int trim_u16(uint16_t* val) noexcept {
+            return _Trim_uint(val);
+        }
+
+        // 从开头读取 32 位无符号整数（网络字节序）
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int trim_u32(uint32_t* val) noexcept {
+            return _Trim_uint(val);
+        }
+
+        // 从开头读取 64 位无符号整数（网络字节序）
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int trim_u64(uint64_t* val) noexcept {
+            return _Trim_uint(val);
+        }
+
+        // 从开头读取指定长度的字节序列
+        // 参数：size - 字节数，bytes - 存储借用消息内存的字节序列
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int trim_bytes(size_t size, std::span<const std::byte>* bytes) noexcept {
+            if (remaining() < size) {
+                return NNG_EINVAL;
+            }
+            *bytes = std::span<const std::byte>(_My_begin, size);
+            _My_begin += size;
+            return NNG_OK;
+        }
+
+        // 从开头读取字符串（Msg::insert_string 的格式：32 位长度在前）
+        // 参数：sv - 存储借用消息内存的字符串视图
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int trim_string(std::string_view* sv) noexcept {
+            const std::byte* _Saved = _My_begin;
+            uint32_t _Len;
+            std::span<const std::byte> _Bytes;
+            if (trim_u32(&_Len) != NNG_OK || trim_bytes(_Len, &_Bytes) != NNG_OK) {
+                _My_begin = _Saved;
+                return NNG_EINVAL;
+            }
+            *sv = std::string_view(reinterpret_cast<const char*>(_Bytes.data()), _Bytes.size());
+            return NNG_OK;
+        }
+
+        // 从末尾读取 16 位无符号整数（网络字节序）
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int chop_u16(uint16_t* val) noexcept {
+            return _Chop_uint(val);
+        }
+
+        // 从末尾读取 32 位无符号整数（网络字节序）
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int chop_u32(uint32_t* val) noexcept {
+            return _Chop_uint(val);
+        }
+
+        // 从末尾读取 64 位无符号整数（网络字节序）
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int chop_u64(uint64_t* val) noexcept {
+            return _Chop_uint(val);
+        }
+
+        // 从末尾读取指定长度的字节序列
+        // 参数：size - 字节数，bytes - 存储借用消息内存的字节序列
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int chop_bytes(size_t size, std::span<const std::byte>* bytes) noexcept {
+            if (remaining() < size) {
+                return NNG_EINVAL;
+            }
+            _My_end -= size;
+            *bytes = std::span<const std::byte>(_My_end, size);
+            return NNG_OK;
+        }
+
+        // 从末尾读取字符串（Msg::append_string 的格式：32 位长度在后）
+        // 参数：sv - 存储借用消息内存的字符串视图
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int chop_string(std::string_view* sv) noexcept {
+            const std::byte* _Saved = _My_end;
+            uint32_t _Len;
+            std::span<const std::byte> _Bytes;
+            if (chop_u32(&_Len) != NNG_OK || chop_bytes(_Len, &_Bytes) != NNG_OK) {
+                _My_end = _Saved;
+                return NNG_EINVAL;
+            }
+            *sv = std::string_view(reinterpret_cast<const char*>(_Bytes.data()), _Bytes.size());
+            return NNG_OK;
+        }
+
+        // 从开头读取结构体（按 Pod<T> 解码）
+        // 参数：val - 存储读取的结构体
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int trim_pod(T* val) noexcept {
+            if (remaining() < Pod<T>::size) {
+                return NNG_EINVAL;
+            }
+            Pod<T>::decode(_My_begin, *val);
+            _My_begin += Pod<T>::size;
+            return NNG_OK;
+        }
+
+        // 从末尾读取结构体（按 Pod<T> 解码）
+        // 参数：val - 存储读取的结构体
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int chop_pod(T* val) noexcept {
+            if (remaining() < Pod<T>::size) {
+                return NNG_EINVAL;
+            }
+            _My_end -= Pod<T>::size;
+            Pod<T>::decode(_My_end, *val);
+            return NNG_OK;
+        }
+
+        // 从开头读取整数数组
+        // 参数：vals - 存储读取的数组，元素个数即要读取的个数；order - 与写入时相同的字节序策略
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int trim_array(std::span<T> vals, FIELD_ORDER order = FO_NETWORK) noexcept {
+            if (remaining() < vals.size_bytes()) {
+                return NNG_EINVAL;
+            }
+            ByteOrder::copy<T>(vals.data(), _My_begin, vals.size(), order);
+            _My_begin += vals.size_bytes();
+            return NNG_OK;
+        }
+
+        // 从末尾读取整数数组
+        // 参数：vals - 存储读取的数组，元素个数即要读取的个数；order - 与写入时相同的字节序策略
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int chop_array(std::span<T> vals, FIELD_ORDER order = FO_NETWORK) noexcept {
+            if (remaining() < vals.size_bytes()) {
+                return NNG_EINVAL;
+            }
+            _My_end -= vals.size_bytes();
+            ByteOrder::copy<T>(vals.data(), _My_end, vals.size(), order);
+            return NNG_OK;
+        }
+
+        // 跳过开头的字节
+        // 参数：size - 字节数
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        int skip(size_t size) noexcept {
+            if (remaining() < size) {
+                return NNG_EINVAL;
+            }
+            _My_begin += size;
+            return NNG_OK;
+        }
+
+        // 获取尚未读取的字节序列
+        // 返回：借用消息内存的字节序列
+        std::span<const std::byte> rest() const noexcept {
+            return std::span<const std::byte>(_My_begin, remaining());
+        }
+
+        // 获取尚未读取的字节数
+        // 返回：字节数
+        size_t remaining() const noexcept {
+            return (size_t)(_My_end - _My_begin);
+        }
+
+        // 检查是否已全部读取
+        // 返回：true 表示没有剩余字节
+        bool empty() const noexcept {
+            return _My_begin == _My_end;
+        }
+
+    private:
+        // 从开头读取网络字节序的无符号整数
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int _Trim_uint(T* val) noexcept {
+            if (remaining() < sizeof(T)) {
+                return NNG_EINVAL;
+            }
+            *val = _Load_be<T>(_My_begin);
+            _My_begin += sizeof(T);
+            return NNG_OK;
+        }
+
+        // 从末尾读取网络字节序的无符号整数
+        // 参数：val - 存储读取的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示长度不足
+        template <typename T>
+        int _Chop_uint(T* val) noexcept {
+            if (remaining() < sizeof(T)) {
+                return NNG_EINVAL;
+            }
+            _My_end -= sizeof(T);
+            *val = _Load_be<T>(_My_end);
+            return NNG_OK;
+        }
+
+        // 按网络字节序读取无符号整数
+        // 参数：p - 数据指针
+        // 返回：读取的值
+        template <typename T>
+        static T _Load_be(const std::byte* p) noexcept {
+            T _Val = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                _Val = (T)((_Val << 8) | (T)p[i]);
+            }
+            return _Val;
+        }
+
+    private:
+        const std::byte* _My_begin;
+        const std::byte* _My_end;
+    };
+}
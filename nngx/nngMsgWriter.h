@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "nngException.h"
+#include "nngMsg.h"
+
+namespace nng
+{
+    // MsgWriter 类：一次分配、原地编码的消息正文写入器
+    // 用途：替代逐个字段调用 Msg::append_* / insert_*，避免每个字段一次重新分配或整体移动
+    // 特性：
+    // - 构造时把正文一次扩展到预计的大小，之后的写入直接编码到缓冲区
+    // - 整数按网络字节序写入，与 Msg::trim_* / chop_* 以及 MsgReader 兼容
+    // - 字符串有两种格式：write_prefixed_string（长度在前，从开头以 trim_string 读取）和
+    //   write_suffixed_string（长度在后，与 append_string 相同，从末尾以 chop_string 读取）
+    // - 写入超出预计大小时返回 NNG_EINVAL；结束时未写满的部分被裁掉
+    // - 已知全部字段时可用静态函数 append 自动计算大小并一次写入
+    class MsgWriter
+    {
+    public:
+        // 构造函数：在消息正文末尾预留空间
+        // 参数：msg - 消息对象，为空时新分配；size - 预计写入的字节数
+        // 异常：若分配失败，抛出 Exception
+        MsgWriter(Msg& msg, size_t size) noexcept(false) : _My_msg(msg) {
+            int rv = _Grow(msg, size, &_My_cursor);
+            if (rv != NNG_OK) {
+                throw Exception(rv, "nng_msg_realloc");
+            }
+            _My_end = _My_cursor + size;
+        }
+
+        // 析构函数：裁掉未写满的部分
+        ~MsgWriter() noexcept {
+            finish();
+        }
+
+        // 禁用拷贝构造函数
+        MsgWriter(const MsgWriter&) = delete;
+
+        // 禁用拷贝赋值运算符
+        MsgWriter& operator=(const MsgWriter&) = delete;
+
+        // 写入 16 位无符号整数（网络字节序）
+        // 参数：val - 要写入的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        int write_u16(uint16_t val) noexcept {
+            return _Write_uint(val);
+        }
+
+        // 写入 32 位无符号整数（网络字节序）
+        // 参数：val - 要写入的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        int write_u32(uint32_t val) noexcept {
+            return _Write_uint(val);
+        }
+
+        // 写入 64 位无符号整数（网络字节序）
+        // 参数：val - 要写入的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        int write_u64(uint64_t val) noexcept {
+            return _Write_uint(val);
+        }
+
+        // 写入字节序列
+        // 参数：data - 数据指针，size - 数据大小
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        int write_bytes(const void* data, size_t size) noexcept {
+            if (remaining() < size) {
+                return NNG_EINVAL;
+            }
+            if (size != 0) {
+                std::memcpy(_My_cursor, data, size);
+                _My_cursor += size;
+            }
+            return NNG_OK;
+        }
+
+        // 写入长度在前的字符串（与 Msg::insert_string 格式相同，从开头以 trim_string 读取）
+        // 参数：sv - 要写入的字符串
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        int write_prefixed_string(std::string_view sv) noexcept {
+            if (remaining() < string_size(sv)) {
+                return NNG_EINVAL;
+            }
+            write_u32((uint32_t)sv.size());
+            return write_bytes(sv.data(), sv.size());
+        }
+
+        // 写入长度在后的字符串（与 Msg::append_string 格式相同，从末尾以 chop_string 读取）
+        // 参数：sv - 要写入的字符串
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        int write_suffixed_string(std::string_view sv) noexcept {
+            if (remaining() < string_size(sv)) {
+                return NNG_EINVAL;
+            }
+            write_bytes(sv.data(), sv.size());
+            return write_u32((uint32_t)sv.size());
+        }
+
+        // 写入结构体（按 Pod<T> 编码）
+        // 参数：val - 要写入的结构体
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        template <typename T>
+        int write_pod(const T& val) noexcept {
+            if (remaining() < Pod<T>::size) {
+                return NNG_EINVAL;
+            }
+            Pod<T>::encode(_My_cursor, val);
+            _My_cursor += Pod<T>::size;
+            return NNG_OK;
+        }
+
+        // 写入整数数组（不写入元素个数）
+        // 参数：vals - 要写入的数组；order - FO_NETWORK 逐个元素转为网络字节序，FO_NATIVE 原样复制
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        template <typename T>
+        int write_array(std::span<const T> vals, FIELD_ORDER order = FO_NETWORK) noexcept {
+            if (remaining() < vals.size_bytes()) {
+                return NNG_EINVAL;
+            }
+            ByteOrder::copy<T>(_My_cursor, vals.data(), vals.size(), order);
+            _My_cursor += vals.size_bytes();
+            return NNG_OK;
+        }
+
+        // 结束写入：裁掉未写满的部分，之后的写入返回 NNG_EINVAL
+        // 说明：析构时自动调用，可重复调用
+        void finish() noexcept {
+            if (_My_cursor != _My_end) {
+                _My_msg.chop(remaining());
+            }
+            _My_end = _My_cursor;
+        }
+
+        // 获取剩余的预计字节数
+        // 返回：字节数
+        size_t remaining() const noexcept {
+            return (size_t)(_My_end - _My_cursor);
+        }
+
+        // 计算字符串编码后的大小
+        // 参数：sv - 字符串
+        // 返回：字节数（32 位长度加字符串内容）
+        static constexpr size_t string_size(std::string_view sv) noexcept {
+            return sizeof(uint32_t) + sv.size();
+        }
+
+        // 一次性追加多个字段：先计算总大小，只扩展一次正文
+        // 参数：msg - 消息对象，为空时新分配；args - 字段，uint16_t / uint32_t / uint64_t 按网络字节序写入，
+        //       可转换为 std::string_view 的字符串按长度在前的格式写入
+        // 返回：操作结果，0 表示成功
+        template <typename... _Args_t>
+        static int append(Msg& msg, const _Args_t&... args) noexcept {
+            uint8_t* _Cursor = nullptr;
+            int rv = _Grow(msg, (_Field_size(args) + ... + 0), &_Cursor);
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            (_Encode(_Cursor, args), ...);
+            return NNG_OK;
+        }
+
+    private:
+        // 扩展消息正文
+        // 参数：msg - 消息对象，size - 扩展的字节数，cursor - 存储扩展部分的起始位置
+        // 返回：操作结果，0 表示成功
+        static int _Grow(Msg& msg, size_t size, uint8_t** cursor) noexcept {
+            size_t _Len = msg ? msg.len() : 0;
+            int rv = msg.realloc(_Len + size);
+            if (rv != NNG_OK) {
+                return rv;
+            }
+            *cursor = static_cast<uint8_t*>(msg.body()) + _Len;
+            return NNG_OK;
+        }
+
+        // 写入网络字节序的无符号整数
+        // 参数：val - 要写入的值
+        // 返回：操作结果，0 表示成功，NNG_EINVAL 表示超出预计大小
+        template <typename T>
+        int _Write_uint(T val) noexcept {
+            if (remaining() < sizeof(T)) {
+                return NNG_EINVAL;
+            }
+            _Store_be(_My_cursor, val);
+            return NNG_OK;
+        }
+
+        // 按网络字节序写入无符号整数并前移游标
+        // 参数：cursor - 写入位置，val - 要写入的值
+        template <typename T>
+        static void _Store_be(uint8_t*& cursor, T val) noexcept {
+            for (size_t i = sizeof(T); i-- > 0;) {
+                cursor[i] = (uint8_t)val;
+                val = (T)(val >> 8);
+            }
+            cursor += sizeof(T);
+        }
+
+        // 计算字段编码后的大小
+        // 参数：arg - 字段
+        // 返回：字节数
+        template <typename T>
+        static constexpr size_t _Field_size(const T& arg) noexcept {
+            if constexpr (std::is_integral_v<T>) {
+                static_assert(std::is_unsigned_v<T> && sizeof(T) >= 2, "MsgWriter: integers must be uint16_t / uint32_t / uint64_t");
+                return sizeof(T);
+            }
+            else {
+                return string_size(std::string_view(arg));
+            }
+        }
+
+        // 编码字段并前移游标
+        // 参数：cursor - 写入位置，arg - 字段
+        template <typename T>
+        static void _Encode(uint8_t*& cursor, const T& arg) noexcept {
+            if constexpr (std::is_integral_v<T>) {
+                _Store_be(cursor, arg);
+            }
+            else {
+                std::string_view _Sv(arg);
+                _Store_be(cursor, (uint32_t)_Sv.size());
+                if (!_Sv.empty()) {
+                    std::memcpy(cursor, _Sv.data(), _Sv.size());
+                    cursor += _Sv.size();
+                }
+            }
+        }
+
+    private:
+        Msg& _My_msg;
+        uint8_t* _My_cursor = nullptr;
+        uint8_t* _My_end = nullptr;
+    };
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+#include "nngByteOrder.h"
+
+namespace nng
+{
+    // Field 类：描述结构体的一个字段
+    // 参数：_Member - 成员指针，_Order - 字节序策略
+    template <auto _Member, FIELD_ORDER _Order = FO_NETWORK>
+    struct Field
+    {
+        static_assert(std::is_member_object_pointer_v<decltype(_Member)>, "Field: _Member must be a pointer to data member");
+        static constexpr auto member = _Member;
+        static constexpr FIELD_ORDER order = _Order;
+    };
+
+    // Fields 类：结构体的字段列表，按编码顺序排列
+    template <typename... _Fields_t>
+    struct Fields {};
+
+    // Schema 类：结构体的编码描述，由使用者特化
+    // 用途：为聚合体声明字段列表与各字段的字节序策略
+    // 说明：特化中定义 using fields = Fields<Field<&T::a>, Field<&T::b, FO_NATIVE>, ...>;
+    //       未特化的类型须可平凡复制，按本机内存表示整体复制
+    template <typename T>
+    struct Schema;
+
+    // Pod 类：结构体的编译期编解码器
+    // 用途：供 Msg、MsgReader、MsgWriter 的 *_pod 函数一次编码或解码整个结构体，替代逐个字段的 append_* / chop_*
+    // 特性：
+    // - 编码大小和各字段偏移均在编译期计算，编解码只是固定偏移上的复制，不分配内存
+    // - 有 Schema 的类型按字段列表紧凑编码（无填充），字段可以是整数、浮点数、枚举、数组或另一个有 Schema 的类型
+    // - 只有 FO_NETWORK 字段做字节序转换；大端主机上不做任何转换
+    // - 没有 Schema 的类型按 sizeof(T) 原样复制，不做字节序转换
+    template <typename T>
+    class Pod
+    {
+        template <typename U>
+        static constexpr bool _Has_schema = requires { typename Schema<U>::fields; };
+
+        template <typename _Mp>
+        struct _Member_type;
+
+        template <typename _Class_t, typename _Value_t>
+        struct _Member_type<_Value_t _Class_t::*>
+        {
+            using type = _Value_t;
+        };
+
+        template <typename _Field_t>
+        using _Value_t = typename _Member_type<std::remove_cv_t<decltype(_Field_t::member)>>::type;
+
+        // 计算值的编码大小
+        template <typename U>
+        static constexpr size_t _Value_size() noexcept {
+            if constexpr (std::is_array_v<U>) {
+                return std::extent_v<U> * _Value_size<std::remove_extent_t<U>>();
+            }
+            else if constexpr (_Has_schema<U>) {
+                return Pod<U>::size;
+            }
+            else {
+                static_assert(std::is_trivially_copyable_v<U>, "Pod: field type must be trivially copyable or have a Schema");
+                return sizeof(U);
+            }
+        }
+
+        template <typename... _Fields_t>
+        static constexpr std::array<size_t, sizeof...(_Fields_t) + 1> _Offsets(Fields<_Fields_t...>) noexcept {
+            std::array<size_t, sizeof...(_Fields_t) + 1> _Result{};
+            size_t _Sizes[] = { _Value_size<_Value_t<_Fields_t>>()..., 0 };
+            for (size_t i = 0; i < sizeof...(_Fields_t); ++i) {
+                _Result[i + 1] = _Result[i] + _Sizes[i];
+            }
+            return _Result;
+        }
+
+        static constexpr auto _Layout() noexcept {
+            if constexpr (_Has_schema<T>) {
+                return _Offsets(typename Schema<T>::fields{});
+            }
+            else {
+                static_assert(std::is_trivially_copyable_v<T>, "Pod: type must be trivially copyable or have a Schema");
+                return std::array<size_t, 2>{ 0, sizeof(T) };
+            }
+        }
+
+        static constexpr auto _My_offsets = _Layout();
+
+    public:
+        // 编码后的字节数
+        static constexpr size_t size = _My_offsets.back();
+
+        // 编码
+        // 参数：dst - 目标缓冲区，至少 size 字节；val - 要编码的值
+        static void encode(void* dst, const T& val) noexcept {
+            if constexpr (_Has_schema<T>) {
+                _Encode_fields(static_cast<uint8_t*>(dst), val, typename Schema<T>::fields{}, std::make_index_sequence<_My_offsets.size() - 1>{});
+            }
+            else {
+                std::memcpy(dst, &val, sizeof(T));
+            }
+        }
+
+        // 解码
+        // 参数：src - 源缓冲区，至少 size 字节；val - 存储解码的值
+        static void decode(const void* src, T& val) noexcept {
+            if constexpr (_Has_schema<T>) {
+                _Decode_fields(static_cast<const uint8_t*>(src), val, typename Schema<T>::fields{}, std::make_index_sequence<_My_offsets.size() - 1>{});
+            }
+            else {
+                std::memcpy(&val, src, sizeof(T));
+            }
+        }
+
+    private:
+        template <typename... _Fields_t, size_t... _Idx>
+        static void _Encode_fields(uint8_t* dst, const T& val, Fields<_Fields_t...>, std::index_sequence<_Idx...>) noexcept {
+            (_Encode_value<_Fields_t::order>(dst + _My_offsets[_Idx], val.*(_Fields_t::member)), ...);
+        }
+
+        template <typename... _Fields_t, size_t... _Idx>
+        static void _Decode_fields(const uint8_t* src, T& val, Fields<_Fields_t...>, std::index_sequence<_Idx...>) noexcept {
+            (_Decode_value<_Fields_t::order>(src + _My_offsets[_Idx], val.*(_Fields_t::member)), ...);
+        }
+
+        // 检查值是否需要转换字节序
+        template <FIELD_ORDER _Order, typename U>
+        static constexpr bool _Swap = _Order == FO_NETWORK && std::endian::native == std::endian::little
+            && (std::is_arithmetic_v<U> || std::is_enum_v<U>) && sizeof(U) > 1;
+
+        // 与 U 等宽的无符号整数
+        template <typename U>
+        using _Bits_t = std::conditional_t<sizeof(U) == 2, uint16_t, std::conditional_t<sizeof(U) == 4, uint32_t, uint64_t>>;
+
+        template <FIELD_ORDER _Order, typename U>
+        static void _Encode_value(uint8_t* dst, const U& val) noexcept {
+            if constexpr (std::is_array_v<U>) {
+                using _Elem_t = std::remove_extent_t<U>;
+                for (size_t i = 0; i < std::extent_v<U>; ++i) {
+                    _Encode_value<_Order>(dst + i * _Value_size<_Elem_t>(), val[i]);
+                }
+            }
+            else if constexpr (_Has_schema<U>) {
+                Pod<U>::encode(dst, val);
+            }
+            else if constexpr (_Swap<_Order, U>) {
+                static_assert(sizeof(U) == 2 || sizeof(U) == 4 || sizeof(U) == 8, "Pod: unsupported field width for FO_NETWORK");
+                _Bits_t<U> _Bits;
+                std::memcpy(&_Bits, &val, sizeof(U));
+                _Bits = ByteOrder::swap(_Bits);
+                std::memcpy(dst, &_Bits, sizeof(U));
+            }
+            else {
+                static_assert(_Order == FO_NATIVE || std::is_arithmetic_v<U> || std::is_enum_v<U>,
+                    "Pod: FO_NETWORK applies to integers, floats, enums, arrays of them and types with a Schema; use FO_NATIVE");
+                std::memcpy(dst, &val, sizeof(U));
+            }
+        }
+
+        template <FIELD_ORDER _Order, typename U>
+        static void _Decode_value(const uint8_t* src, U& val) noexcept {
+            if constexpr (std::is_array_v<U>) {
+                using _Elem_t = std::remove_extent_t<U>;
+                for (size_t i = 0; i < std::extent_v<U>; ++i) {
+                    _Decode_value<_Order>(src + i * _Value_size<_Elem_t>(), val[i]);
+                }
+            }
+            else if constexpr (_Has_schema<U>) {
+                Pod<U>::decode(src, val);
+            }
+            else if constexpr (_Swap<_Order, U>) {
+                _Bits_t<U> _Bits;
+                std::memcpy(&_Bits, src, sizeof(U));
+                _Bits = ByteOrder::swap(_Bits);
+                std::memcpy(&val, &_Bits, sizeof(U));
+            }
+            else {
+                std::memcpy(&val, src, sizeof(U));
+            }
+        }
+    };
+}
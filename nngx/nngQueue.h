@@ -0,0 +1,259 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "nngException.h"
+
+namespace nng
+{
+    // MpscQueue 类：有界无锁多生产者/单消费者环形队列
+    // 用途：为 AsyncSender 等高并发提交场景提供无互斥锁的消息队列
+    // 特性：
+    // - 容量向上取整为 2 的幂，创建后固定，不再分配内存
+    // - 生产者入队只需一次 CAS 抢占位置，消费者出队不需要任何原子读改写
+    // - 每个单元带序号，生产者写入完成后才对消费者可见
+    // - 仅允许一个消费者线程同时调用 try_pop（由调用方保证）
+    template <typename T>
+    class MpscQueue
+    {
+        typedef struct alignas(64) _CELL
+        {
+            std::atomic<size_t> _Sequence;
+            T _Value;
+        } CELL, * PCELL;
+
+    public:
+        // 构造函数：创建指定容量的队列
+        // 参数：capacity - 队列容量，向上取整为 2 的幂，最小为 2
+        // 异常：若分配失败，抛出 std::bad_alloc
+        explicit MpscQueue(size_t capacity) noexcept(false) {
+            size_t _Size = 2;
+            while (_Size < capacity) {
+                _Size <<= 1;
+            }
+
+            _My_cells = std::make_unique<CELL[]>(_Size);
+            _My_mask = _Size - 1;
+            for (size_t i = 0; i < _Size; ++i) {
+                _My_cells[i]._Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // 禁用拷贝构造函数
+        MpscQueue(const MpscQueue&) = delete;
+
+        // 禁用拷贝赋值运算符
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        // 尝试入队（多生产者安全）
+        // 参数：value - 要入队的元素，成功时被移走
+        // 返回：true 表示成功，false 表示队列已满
+        bool try_push(T&& value) noexcept {
+            PCELL _Cell;
+            size_t _Pos = _My_enqueue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                _Cell = &_My_cells[_Pos & _My_mask];
+                size_t _Seq = _Cell->_Sequence.load(std::memory_order_acquire);
+                intptr_t _Diff = (intptr_t)_Seq - (intptr_t)_Pos;
+                if (_Diff == 0) {
+                    if (_My_enqueue_pos.compare_exchange_weak(_Pos, _Pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (_Diff < 0) {
+                    return false;
+                }
+                else {
+                    _Pos = _My_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            _Cell->_Value = std::move(value);
+            _Cell->_Sequence.store(_Pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 尝试批量入队（多生产者安全）
+        // 参数：count - 期望入队的元素数量，gen - 无参函数，每次调用返回下一个要入队的元素
+        // 返回：实际入队的元素数量（连续可用位置不足时可能小于 count），0 表示队列已满
+        // 说明：先确认连续的空闲位置，再以一次 CAS 整段抢占；gen 仅对抢占到的位置调用，且按顺序调用
+        template <typename _Gen_t>
+        size_t try_push_bulk(size_t count, _Gen_t&& gen) noexcept {
+            if (count == 0) {
+                return 0;
+            }
+
+            size_t _Pos = _My_enqueue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                size_t _Count = 0;
+                intptr_t _Diff = 0;
+                while (_Count < count) {
+                    size_t _Seq = _My_cells[(_Pos + _Count) & _My_mask]._Sequence.load(std::memory_order_acquire);
+                    _Diff = (intptr_t)_Seq - (intptr_t)(_Pos + _Count);
+                    if (_Diff != 0) {
+                        break;
+                    }
+                    ++_Count;
+                }
+
+                if (_Count == 0) {
+                    if (_Diff < 0) {
+                        return 0;
+                    }
+                    _Pos = _My_enqueue_pos.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (_My_enqueue_pos.compare_exchange_weak(_Pos, _Pos + _Count, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < _Count; ++i) {
+                        PCELL _Cell = &_My_cells[(_Pos + i) & _My_mask];
+                        _Cell->_Value = gen();
+                        _Cell->_Sequence.store(_Pos + i + 1, std::memory_order_release);
+                    }
+                    return _Count;
+                }
+            }
+        }
+
+        // 尝试出队（仅限单消费者）
+        // 参数：value - 存储出队元素
+        // 返回：true 表示成功，false 表示队列为空（或队首元素尚未写入完成）
+        bool try_pop(T& value) noexcept {
+            size_t _Pos = _My_dequeue_pos.load(std::memory_order_relaxed);
+            PCELL _Cell = &_My_cells[_Pos & _My_mask];
+            size_t _Seq = _Cell->_Sequence.load(std::memory_order_acquire);
+            if ((intptr_t)_Seq - (intptr_t)(_Pos + 1) < 0) {
+                return false;
+            }
+
+            value = std::move(_Cell->_Value);
+            _Cell->_Value = T();
+            _Cell->_Sequence.store(_Pos + _My_mask + 1, std::memory_order_release);
+            _My_dequeue_pos.store(_Pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // 检查队首是否有可出队的元素
+        // 返回：true 表示队列为空（或队首元素尚未写入完成）
+        bool empty() const noexcept {
+            size_t _Pos = _My_dequeue_pos.load(std::memory_order_relaxed);
+            size_t _Seq = _My_cells[_Pos & _My_mask]._Sequence.load(std::memory_order_acquire);
+            return (intptr_t)_Seq - (intptr_t)(_Pos + 1) < 0;
+        }
+
+        // 获取队列中元素数量的近似值
+        // 返回：已入队但尚未出队的元素数量
+        size_t size() const noexcept {
+            size_t _Enqueue = _My_enqueue_pos.load(std::memory_order_relaxed);
+            size_t _Dequeue = _My_dequeue_pos.load(std::memory_order_relaxed);
+            return _Enqueue > _Dequeue ? _Enqueue - _Dequeue : 0;
+        }
+
+        // 获取队列容量
+        // 返回：队列容量
+        size_t capacity() const noexcept {
+            return _My_mask + 1;
+        }
+
+    private:
+        std::unique_ptr<CELL[]> _My_cells;
+        size_t _My_mask = 0;
+        alignas(64) std::atomic<size_t> _My_enqueue_pos{ 0 };   // 生产者共享
+        alignas(64) std::atomic<size_t> _My_dequeue_pos{ 0 };   // 仅消费者写入
+    };
+
+    // SpscQueue 类：有界无锁单生产者/单消费者环形队列
+    // 用途：为按键保序分发的各个工作通道提供无互斥锁的消息队列
+    // 特性：
+    // - 容量向上取整为 2 的幂，创建后固定，不再分配内存
+    // - 入队和出队都不需要原子读改写，只各自发布自己的位置
+    // - 生产者和消费者各自缓存对方的位置，只有缓存显示已满或为空时才读取对方的原子变量
+    // - 仅允许一个生产者线程和一个消费者线程（由调用方保证）
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        // 构造函数：创建指定容量的队列
+        // 参数：capacity - 队列容量，向上取整为 2 的幂，最小为 2
+        // 异常：若分配失败，抛出 std::bad_alloc
+        explicit SpscQueue(size_t capacity) noexcept(false) {
+            size_t _Size = 2;
+            while (_Size < capacity) {
+                _Size <<= 1;
+            }
+
+            _My_values = std::make_unique<T[]>(_Size);
+            _My_mask = _Size - 1;
+        }
+
+        // 禁用拷贝构造函数
+        SpscQueue(const SpscQueue&) = delete;
+
+        // 禁用拷贝赋值运算符
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // 尝试入队（仅限单生产者）
+        // 参数：value - 要入队的元素，成功时被移走
+        // 返回：true 表示成功，false 表示队列已满
+        bool try_push(T&& value) noexcept {
+            size_t _Pos = _My_tail.load(std::memory_order_relaxed);
+            if (_Pos - _My_head_cache > _My_mask) {
+                _My_head_cache = _My_head.load(std::memory_order_acquire);
+                if (_Pos - _My_head_cache > _My_mask) {
+                    return false;
+                }
+            }
+
+            _My_values[_Pos & _My_mask] = std::move(value);
+            _My_tail.store(_Pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 尝试出队（仅限单消费者）
+        // 参数：value - 存储出队元素
+        // 返回：true 表示成功，false 表示队列为空
+        bool try_pop(T& value) noexcept {
+            size_t _Pos = _My_head.load(std::memory_order_relaxed);
+            if (_Pos == _My_tail_cache) {
+                _My_tail_cache = _My_tail.load(std::memory_order_acquire);
+                if (_Pos == _My_tail_cache) {
+                    return false;
+                }
+            }
+
+            value = std::move(_My_values[_Pos & _My_mask]);
+            _My_values[_Pos & _My_mask] = T{};
+            _My_head.store(_Pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 检查队列是否为空
+        // 返回：true 表示队列为空
+        bool empty() const noexcept {
+            return _My_head.load(std::memory_order_acquire) == _My_tail.load(std::memory_order_acquire);
+        }
+
+        // 获取队列中元素数量的近似值
+        // 返回：已入队但尚未出队的元素数量
+        size_t size() const noexcept {
+            return _My_tail.load(std::memory_order_acquire) - _My_head.load(std::memory_order_acquire);
+        }
+
+        // 获取队列容量
+        // 返回：队列容量
+        size_t capacity() const noexcept {
+            return _My_mask + 1;
+        }
+
+    private:
+        std::unique_ptr<T[]> _My_values;
+        size_t _My_mask = 0;
+        alignas(64) std::atomic<size_t> _My_tail{ 0 };  // 仅生产者写入
+        size_t _My_head_cache = 0;                      // 生产者缓存的出队位置
+        alignas(64) std::atomic<size_t> _My_head{ 0 };  // 仅消费者写入
+        size_t _My_tail_cache = 0;                      // 消费者缓存的入队位置
+    };
+}
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "nngException.h"
+#include "nngMsg.h"
+#include "nngInplaceFunction.h"
+
+namespace nng
+{
+    // Handler 类：编译期路由表的一项，把消息代码绑定到处理函数
+    // 参数：_Code - 消息代码，_Fn - 处理函数，以 std::invoke(_Fn, owner, msg) 调用：
+    //       可以是成员函数指针 &X::f（X::f(Msg&)），也可以是自由函数 f(X&, Msg&)；返回 Msg::_Ty_msg_result 或 void
+    template <Msg::_Ty_msg_code _Code, auto _Fn>
+    struct Handler
+    {
+        static constexpr Msg::_Ty_msg_code _Code_v = _Code;
+        static constexpr auto _Fn_v = _Fn;
+    };
+
+    // Router 类：编译期消息代码路由表
+    // 用途：替代 _On_message 中按消息代码的 switch，把消息直接转给注册的处理函数
+    // 特性：
+    // - 处理函数在编译期确定，经由不含虚调用的跳板函数调用，可被内联
+    // - 消息代码连续（跨度不超过 4 倍项数或 64）时使用按代码下标的跳转表
+    // - 否则在编译期搜索完美散列（乘法散列，表大小为 2 的幂），一次乘法和一次比较即可定位
+    // - 找不到完美散列时退回有序表二分查找
+    // - 重复的消息代码在编译期报错
+    template <typename... _Handlers_t>
+    class Router
+    {
+        template <typename _Owner_t>
+        using _Fn_t = Msg::_Ty_msg_result(*)(_Owner_t&, Msg&);
+
+        template <typename _Owner_t>
+        struct _ENTRY
+        {
+            Msg::_Ty_msg_code _Code = 0;
+            _Fn_t<_Owner_t> _Fn = nullptr;
+        };
+
+        // 完美散列参数
+        struct _HASH
+        {
+            uint64_t _Mult = 0;
+            unsigned _Shift = 0;
+            size_t _Size = 0;       // 0 表示未找到
+        };
+
+        static constexpr size_t _Count = sizeof...(_Handlers_t);
+        static constexpr std::array<Msg::_Ty_msg_code, _Count> _Codes{ _Handlers_t::_Code_v... };
+
+        static constexpr bool _Unique() {
+            auto _Sorted = _Codes;
+            std::sort(_Sorted.begin(), _Sorted.end());
+            return std::adjacent_find(_Sorted.begin(), _Sorted.end()) == _Sorted.end();
+        }
+        static_assert(_Unique(), "Router: duplicate message code");
+
+        static constexpr Msg::_Ty_msg_code _Min = _Count ? *std::min_element(_Codes.begin(), _Codes.end()) : 0;
+        static constexpr Msg::_Ty_msg_code _Max = _Count ? *std::max_element(_Codes.begin(), _Codes.end()) : 0;
+        static constexpr bool _Dense = _Count != 0 && _Max - _Min < (std::max)((Msg::_Ty_msg_code)_Count * 4, (Msg::_Ty_msg_code)64);
+        static constexpr size_t _Max_hash_size = std::bit_ceil(_Count) * 16;
+
+        // 搜索完美散列：从 2 倍项数的表开始，每种大小尝试若干乘数，不行再加倍
+        static constexpr _HASH _Find_hash() {
+            if constexpr (_Count < 2) {
+                return {};
+            }
+            else {
+                for (size_t _Size = std::bit_ceil(_Count * 2); _Size <= _Max_hash_size; _Size <<= 1) {
+                    unsigned _Shift = 64 - (unsigned)std::countr_zero(_Size);
+                    for (uint64_t k = 0; k < 256; ++k) {
+                        uint64_t _Mult = 0x9E3779B97F4A7C15ull + k * 2;
+                        std::array<bool, _Max_hash_size> _Used{};
+                        bool _Ok = true;
+                        for (auto _Code : _Codes) {
+                            size_t _Idx = (size_t)((_Code * _Mult) >> _Shift);
+                            if (_Used[_Idx]) {
+                                _Ok = false;
+                                break;
+                            }
+                            _Used[_Idx] = true;
+                        }
+                        if (_Ok) {
+                            return { _Mult, _Shift, _Size };
+                        }
+                    }
+                }
+                return {};
+            }
+        }
+        static constexpr _HASH _Hash = _Dense ? _HASH{} : _Find_hash();
+
+        // 跳板函数：调用处理函数，void 返回值按默认结果处理
+        template <typename _Owner_t, typename _Handler_t>
+        static Msg::_Ty_msg_result _Invoke(_Owner_t& owner, Msg& msg) {
+            if constexpr (std::is_void_v<std::invoke_result_t<decltype(_Handler_t::_Fn_v), _Owner_t&, Msg&>>) {
+                std::invoke(_Handler_t::_Fn_v, owner, msg);
+                return {};
+            }
+            else {
+                return std::invoke(_Handler_t::_Fn_v, owner, msg);
+            }
+        }
+
+        template <typename _Owner_t>
+        static constexpr std::array<_ENTRY<_Owner_t>, _Count> _Entries{ _ENTRY<_Owner_t>{ _Handlers_t::_Code_v, &_Invoke<_Owner_t, _Handlers_t> }... };
+
+        // 跳转表：下标为消息代码减去最小代码
+        template <typename _Owner_t>
+        static constexpr auto _Build_dense() {
+            std::array<_Fn_t<_Owner_t>, (size_t)(_Max - _Min + 1)> _Table{};
+            for (auto& _Entry : _Entries<_Owner_t>) {
+                _Table[(size_t)(_Entry._Code - _Min)] = _Entry._Fn;
+            }
+            return _Table;
+        }
+
+        // 散列表：每个槽至多一项，查找时比较代码
+        template <typename _Owner_t>
+        static constexpr auto _Build_hash() {
+            std::array<_ENTRY<_Owner_t>, (std::max)(_Hash._Size, (size_t)1)> _Table{};
+            for (auto& _Entry : _Entries<_Owner_t>) {
+                _Table[(size_t)((_Entry._Code * _Hash._Mult) >> _Hash._Shift)] = _Entry;
+            }
+            return _Table;
+        }
+
+        // 有序表：按代码升序
+        template <typename _Owner_t>
+        static constexpr auto _Build_sorted() {
+            auto _Table = _Entries<_Owner_t>;
+            std::sort(_Table.begin(), _Table.end(), [](const auto& _Left, const auto& _Right) { return _Left._Code < _Right._Code; });
+            return _Table;
+        }
+
+    public:
+        // 路由一条消息
+        // 参数：owner - 处理函数所属对象，code - 消息代码，msg - 消息对象，result - 存储处理结果
+        // 返回：true 表示找到处理函数并已调用，false 表示没有注册该消息代码
+        template <typename _Owner_t>
+        static bool route(_Owner_t& owner, Msg::_Ty_msg_code code, Msg& msg, Msg::_Ty_msg_result& result) {
+            _Fn_t<_Owner_t> _Fn = nullptr;
+            if constexpr (_Count == 0) {
+                return false;
+            }
+            else if constexpr (_Dense) {
+                static constexpr auto _Table = _Build_dense<_Owner_t>();
+                Msg::_Ty_msg_code _Idx = code - _Min;
+                if (_Idx < _Table.size()) {
+                    _Fn = _Table[(size_t)_Idx];
+                }
+            }
+            else if constexpr (_Hash._Size != 0) {
+                static constexpr auto _Table = _Build_hash<_Owner_t>();
+                auto& _Entry = _Table[(size_t)((code * _Hash._Mult) >> _Hash._Shift)];
+                if (_Entry._Fn && _Entry._Code == code) {
+                    _Fn = _Entry._Fn;
+                }
+            }
+            else {
+                static constexpr auto _Table = _Build_sorted<_Owner_t>();
+                auto _It = std::lower_bound(_Table.begin(), _Table.end(), code, [](const auto& _Entry, Msg::_Ty_msg_code _Code) { return _Entry._Code < _Code; });
+                if (_It != _Table.end() && _It->_Code == code) {
+                    _Fn = _It->_Fn;
+                }
+            }
+
+            if (!_Fn) {
+                return false;
+            }
+            result = _Fn(owner, msg);
+            return true;
+        }
+
+        // 路由一条消息
+        // 参数：owner - 处理函数所属对象，code - 消息代码，msg - 消息对象，unmatched - 没有注册该消息代码时的结果
+        // 返回：处理结果
+        template <typename _Owner_t>
+        static Msg::_Ty_msg_result dispatch(_Owner_t& owner, Msg::_Ty_msg_code code, Msg& msg, Msg::_Ty_msg_result unmatched = {}) {
+            Msg::_Ty_msg_result _Result = unmatched;
+            route(owner, code, msg, _Result);
+            return _Result;
+        }
+
+        // 获取注册的处理函数数量
+        // 返回：处理函数数量
+        static constexpr size_t size() noexcept {
+            return _Count;
+        }
+    };
+
+    // RouteMap 类：运行期注册的消息代码路由表（开放寻址的扁平散列表）
+    // 用途：插件等运行期才确定的处理函数按消息代码注册，替代 switch 或 std::unordered_map
+    // 特性：
+    // - 线性探测，槽连续存放，查找通常只访问一个缓存行
+    // - 处理函数为 InplaceFunction，注册时不为处理函数分配堆内存
+    // - 删除采用后移法，不留墓碑
+    // - 注册和删除非线程安全；不修改时可被多个线程同时路由
+    class RouteMap
+    {
+    public:
+        using Fn = InplaceFunction<Msg::_Ty_msg_result(Msg&)>;
+
+    private:
+        typedef struct _SLOT
+        {
+            Msg::_Ty_msg_code _Code = 0;
+            bool _Used = false;
+            Fn _Fn;
+        } SLOT, * PSLOT;
+
+    public:
+        // 构造函数：创建路由表
+        // 参数：capacity - 预期的处理函数数量
+        // 异常：若分配失败，抛出 std::bad_alloc
+        explicit RouteMap(size_t capacity = 16) noexcept(false) {
+            _Rehash(std::bit_ceil((std::max)(capacity * 2, (size_t)8)));
+        }
+
+        // 注册处理函数
+        // 参数：code - 消息代码，fn - 处理函数
+        // 返回：操作结果，0 表示成功；NNG_EEXIST 表示该消息代码已注册
+        // 异常：若扩容时分配失败，抛出 std::bad_alloc
+        int add(Msg::_Ty_msg_code code, Fn&& fn) noexcept(false) {
+            if (_Find(code)) {
+                return NNG_EEXIST;
+            }
+            if ((_My_size + 1) * 2 > _My_slots.size()) {
+                _Rehash(_My_slots.size() * 2);
+            }
+            _Insert(code, std::move(fn));
+            return NNG_OK;
+        }
+
+        // 删除处理函数
+        // 参数：code - 消息代码
+        // 返回：true 表示已删除，false 表示未注册
+        bool remove(Msg::_Ty_msg_code code) noexcept {
+            PSLOT _Slot = _Find(code);
+            if (!_Slot) {
+                return false;
+            }
+
+            // 后移法：把后续探测链上可以前移的项依次前移，填补空位
+            size_t _Hole = (size_t)(_Slot - _My_slots.data());
+            _My_slots[_Hole]._Used = false;
+            _My_slots[_Hole]._Fn = nullptr;
+            for (size_t _Next = (_Hole + 1) & _My_mask; _My_slots[_Next]._Used; _Next = (_Next + 1) & _My_mask) {
+                size_t _Home = _Index(_My_slots[_Next]._Code);
+                if (((_Next - _Home) & _My_mask) >= ((_Next - _Hole) & _My_mask)) {
+                    _My_slots[_Hole]._Code = _My_slots[_Next]._Code;
+                    _My_slots[_Hole]._Fn = std::move(_My_slots[_Next]._Fn);
+                    _My_slots[_Hole]._Used = true;
+                    _My_slots[_Next]._Used = false;
+                    _Hole = _Next;
+                }
+            }
+            --_My_size;
+            return true;
+        }
+
+        // 路由一条消息
+        // 参数：code - 消息代码，msg - 消息对象，result - 存储处理结果
+        // 返回：true 表示找到处理函数并已调用，false 表示没有注册该消息代码
+        bool route(Msg::_Ty_msg_code code, Msg& msg, Msg::_Ty_msg_result& result) const {
+            const SLOT* _Slot = const_cast<RouteMap*>(this)->_Find(code);
+            if (!_Slot) {
+                return false;
+            }
+            result = _Slot->_Fn(msg);
+            return true;
+        }
+
+        // 路由一条消息
+        // 参数：code - 消息代码，msg - 消息对象，unmatched - 没有注册该消息代码时的结果
+        // 返回：处理结果
+        Msg::_Ty_msg_result dispatch(Msg::_Ty_msg_code code, Msg& msg, Msg::_Ty_msg_result unmatched = {}) const {
+            Msg::_Ty_msg_result _Result = unmatched;
+            route(code, msg, _Result);
+            return _Result;
+        }
+
+        // 检查消息代码是否已注册
+        // 参数：code - 消息代码
+        // 返回：true 表示已注册
+        bool contains(Msg::_Ty_msg_code code) const noexcept {
+            return const_cast<RouteMap*>(this)->_Find(code) != nullptr;
+        }
+
+        // 获取注册的处理函数数量
+        // 返回：处理函数数量
+        size_t size() const noexcept {
+            return _My_size;
+        }
+
+        // 删除全部处理函数
+        void clear() noexcept {
+            for (auto& _Slot : _My_slots) {
+                _Slot._Used = false;
+                _Slot._Fn = nullptr;
+            }
+            _My_size = 0;
+        }
+
+    private:
+        // 计算消息代码的起始槽
+        // 参数：code - 消息代码
+        // 返回：槽下标
+        size_t _Index(Msg::_Ty_msg_code code) const noexcept {
+            return (size_t)((code * 0x9E3779B97F4A7C15ull) >> _My_shift);
+        }
+
+        // 查找消息代码所在的槽
+        // 参数：code - 消息代码
+        // 返回：槽指针，未注册时为 nullptr
+        PSLOT _Find(Msg::_Ty_msg_code code) noexcept {
+            for (size_t i = _Index(code); _My_slots[i]._Used; i = (i + 1) & _My_mask) {
+                if (_My_slots[i]._Code == code) {
+                    return &_My_slots[i];
+                }
+            }
+            return nullptr;
+        }
+
+        // 插入一项（调用方保证消息代码未注册且有空槽）
+        // 参数：code - 消息代码，fn - 处理函数
+        void _Insert(Msg::_Ty_msg_code code, Fn&& fn) noexcept {
+            size_t i = _Index(code);
+            while (_My_slots[i]._Used) {
+                i = (i + 1) & _My_mask;
+            }
+            _My_slots[i]._Code = code;
+            _My_slots[i]._Fn = std::move(fn);
+            _My_slots[i]._Used = true;
+            ++_My_size;
+        }
+
+        // 重建散列表
+        // 参数：size - 新的槽数量（2 的幂）
+        // 异常：若分配失败，抛出 std::bad_alloc
+        void _Rehash(size_t size) noexcept(false) {
+            std::vector<SLOT> _Old(size);
+            _Old.swap(_My_slots);
+            _My_mask = size - 1;
+            _My_shift = 64 - (unsigned)std::countr_zero(size);
+            _My_size = 0;
+            for (auto& _Slot : _Old) {
+                if (_Slot._Used) {
+                    _Insert(_Slot._Code, std::move(_Slot._Fn));
+                }
+            }
+        }
+
+    private:
+        std::vector<SLOT> _My_slots;
+        size_t _My_mask = 0;
+        unsigned _My_shift = 64;
+        size_t _My_size = 0;
+    };
+}
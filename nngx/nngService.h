@@ -1,6 +1,12 @@
 #pragma once
 
+#include <thread>
+#include <vector>
+#include <deque>
+
 #include "nngException.h"
+#include "nngCtx.h"
+#include "nngDispatcher.h"
 
 namespace nng
 {
@@ -10,6 +16,8 @@ namespace nng
     // - 基于模板参数 _TyBase 扩展功能，适用于不同类型的 NNG 连接器（如 Listener 或 Dialer）
     // - 使用 RAII 管理调度线程，确保在析构时自动停止
     // - 支持异步调度，通过独立线程调用基类的 dispatch 方法
+    // - 支持多个调度线程：Rep、Respondent、Sub 每个线程使用独立的 Ctx，其它协议的线程共享套接字
+    // - 基类开启按键保序分发（DispatcherNoReturn::set_key_ordered）时只使用一个接收线程，由工作通道并行处理
     template <typename _TyBase>
     class Service
         : public _TyBase
@@ -22,47 +30,52 @@ namespace nng
         }
     public:
         // 启动调度线程
-        // 参数：addr - 服务监听或连接的地址，flags - 启动标志，默认为 0，cb - 发起连接之前的回调
+        // 参数：addr - 服务监听或连接的地址，flags - 启动标志，默认为 0，cb - 发起连接之前的回调，
+        //       threads - 调度线程数，默认为 1
         // 返回：操作结果，0 表示成功，非 0 表示失败
-        // 异常：若基类启动失败，可能抛出 Exception
+        // 异常：若基类启动失败或上下文创建失败，可能抛出 Exception
+        // 说明：threads 大于 1 时处理回调会被并发调用，须自行保证线程安全
         template <typename _Peer_t>
         int start_dispatch(
             std::string_view addr,
             int flags = 0,
-            std::function<void(_Peer_t&)> cb = {}) noexcept(false)
+            std::function<void(_Peer_t&)> cb = {},
+            size_t threads = 1) noexcept(false)
         {
             int rv = _TyBase::start(addr, flags, cb);
             if (rv != NNG_OK) {
                 return rv;
             }
 
-            _My_dispatch_thread = std::thread(
-                [=]
-                {
-                    _TyBase::dispatch();
-                }
-            );
-
-            return NNG_OK;
+            return _Start_threads(threads);
         }
 
         int start_dispatch(
             std::string_view addr,
             int flags = 0) noexcept(false)
+        {
+            return start_dispatch(addr, flags, (size_t)1);
+        }
+
+        // 以多个调度线程启动
+        // 参数：addr - 服务监听或连接的地址，flags - 启动标志，threads - 调度线程数
+        // 返回：操作结果，0 表示成功，非 0 表示失败
+        // 异常：若基类启动失败或上下文创建失败，可能抛出 Exception
+        // 说明：
+        // - Rep、Respondent、Sub 每个线程在独立的 Ctx 上接收和回复，多个请求可同时处理
+        // - 其它协议的线程共享套接字接收
+        // - 处理回调会被并发调用，须自行保证线程安全
+        int start_dispatch(
+            std::string_view addr,
+            int flags,
+            size_t threads) noexcept(false)
         {
             int rv = _TyBase::start(addr, flags);
             if (rv != NNG_OK) {
                 return rv;
             }
 
-            _My_dispatch_thread = std::thread(
-                [=]
-                {
-                    _TyBase::dispatch();
-                }
-            );
-
-            return NNG_OK;
+            return _Start_threads(threads);
         }
 
         // 检查调度线程是否可加入
@@ -72,15 +85,20 @@ namespace nng
             return _My_dispatch_thread.joinable();
         }
 
-        // 加入调度线程，等待其完成。
+        // 加入全部调度线程，等待其完成。
         // 注意：仅在线程可加入时调用。
         inline void join() {
             _My_dispatch_thread.join();
+            for (auto& _Thread : _My_dispatch_threads) {
+                _Thread.join();
+            }
+            _My_dispatch_threads.clear();
+            _My_dispatch_ctxs.clear();
         }
 
         // 停止调度线程
         // 返回：true 表示成功停止并加入线程，false 表示线程不可加入
-        // 说明：调用基类的 close 方法关闭连接器，并等待调度线程结束
+        // 说明：调用基类的 close 方法关闭连接器，并等待全部调度线程结束；按键保序分发时还等待已入队的消息处理完成
         bool stop_dispatch() noexcept
         {
             if (!_My_dispatch_thread.joinable()) {
@@ -89,11 +107,75 @@ namespace nng
 
             _TyBase::close();
 
-            _My_dispatch_thread.join();
+            join();
+
+            if constexpr (std::is_base_of_v<DispatcherNoReturn, _TyBase>) {
+                _TyBase::_Drain_key_ordered();
+            }
 
             return true;
         }
+
+    private:
+        // 创建调度线程
+        // 参数：threads - 调度线程数，0 按 1 处理
+        // 返回：操作结果，0 表示成功；_On_dispatch_ctx 失败时关闭连接器并返回其错误码
+        // 异常：若上下文或线程创建失败，抛出 Exception 或 std::system_error
+        int _Start_threads(size_t threads) noexcept(false)
+        {
+            if constexpr (std::is_base_of_v<DispatcherNoReturn, _TyBase>) {
+                // 工作通道的队列只允许一个生产者
+                if (_TyBase::key_ordered()) {
+                    threads = 1;
+                }
+            }
+
+            if (threads <= 1 || !_TyBase::_Dispatch_with_ctx) {
+                _My_dispatch_thread = std::thread(
+                    [this]
+                    {
+                        _TyBase::dispatch();
+                    }
+                );
+                for (size_t i = 1; i < threads; ++i) {
+                    _My_dispatch_threads.emplace_back(
+                        [this]
+                        {
+                            _TyBase::dispatch();
+                        }
+                    );
+                }
+                return NNG_OK;
+            }
+
+            // 先创建全部上下文，失败时不留下半启动的线程
+            for (size_t i = 0; i < threads; ++i) {
+                auto& _Ctx = _My_dispatch_ctxs.emplace_back(_TyBase::Socket::get());
+                int rv = this->_On_dispatch_ctx(_Ctx);
+                if (rv != NNG_OK) {
+                    _TyBase::close();
+                    _My_dispatch_ctxs.clear();
+                    return rv;
+                }
+            }
+            for (auto& _Ctx : _My_dispatch_ctxs) {
+                auto _Proc = [this, &_Ctx]
+                    {
+                        _TyBase::dispatch(_Ctx);
+                    };
+                if (!_My_dispatch_thread.joinable()) {
+                    _My_dispatch_thread = std::thread(_Proc);
+                }
+                else {
+                    _My_dispatch_threads.emplace_back(_Proc);
+                }
+            }
+            return NNG_OK;
+        }
+
     protected:
-        std::thread _My_dispatch_thread;    // _Tcp_base_parser -> virtual class
+        std::thread _My_dispatch_thread;                // 第一个（单线程时唯一的）调度线程，_Tcp_base_parser -> virtual class
+        std::vector<std::thread> _My_dispatch_threads;  // 多线程分发时的其余调度线程
+        std::deque<Ctx> _My_dispatch_ctxs;              // 多线程分发时各线程的上下文，std::deque 保证地址不变
     };
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "nngException.h"
 #include "nngDispatcher.h"
 #include "nngAio.h"
+#include "nngCtx.h"
+#include "nngExecutor.h"
 #include "nngx.h"
 
 namespace nng
@@ -13,11 +15,28 @@ namespace nng
     // - 基于模板参数 _TyBase 扩展功能，适用于不同类型的 NNG 连接器（如 Listener 或 Dialer）
     // - 使用 RAII 管理 aio 资源，确保在析构时自动释放
     // - 支持异步调度，通过 nng_aio 回调机制实现异步消息处理
+    // - 支持多个工作项并发处理：Rep、Respondent、Sub 每个工作项使用独立的 Ctx + Aio，其它协议在套接字上同时挂起多个接收
+    // - 可通过 set_executor 把消息处理转交给执行器（如 ThreadPool），aio 回调线程只负责 I/O 完成
+    // - 基类开启按键保序分发（DispatcherNoReturn::set_key_ordered）时只使用一个工作项，由工作通道并行处理
     // - 提供启动和停止异步调度的功能
     template <typename _TyBase>
     class ServiceAio
         : public _TyBase
     {
+        typedef struct _WORK_ITEM
+        {
+            Aio _Aio;
+            std::optional<Ctx> _Ctx;    // 为空时直接在套接字上接收和回复
+            ServiceAio* _Owner;
+
+            // 工作项构造函数
+            // 参数：callback - 回调函数，owner - 父对象
+            // 异常：若 Aio 创建失败，抛出 Exception
+            explicit _WORK_ITEM(void (*callback)(void*), ServiceAio* owner) noexcept(false)
+                : _Aio(callback, this), _Owner(owner) {
+            }
+        } WORK_ITEM, * PWORK_ITEM;
+
     public:
         // 析构函数：停止异步调度并清理资源
         virtual ~ServiceAio()
@@ -27,50 +46,65 @@ namespace nng
 
     public:
         // 启动异步调度
-        // 参数：addr - 服务监听或连接的地址，flags - 启动标志，默认为 0，cb - 发起连接之前的回调
+        // 参数：addr - 服务监听或连接的地址，flags - 启动标志，默认为 0，cb - 发起连接之前的回调，
+        //       parallel - 并发工作项数，默认为 1
         // 返回：操作结果，0 表示成功，非 0 表示失败
         // 异常：若基类启动失败，可能抛出 Exception
         template <typename _Peer_t>
         int start_dispatch(
             std::string_view addr,
             int flags = 0,
-            std::function<void(_Peer_t&)> cb = {}) noexcept(false)
+            std::function<void(_Peer_t&)> cb = {},
+            size_t parallel = 1) noexcept(false)
         {
             int rv = _TyBase::start(addr, flags, cb);
             if (rv != NNG_OK) {
                 return rv;
             }
 
-            // 创建 aio 对象用于异步调度
-            _My_aio = std::make_unique<Aio>(_Aio_callback, this);
-            if (!_My_aio) {
-                return NNG_ENOMEM;
-            }
-
             // 开始异步调度
-            _Start_async_dispatch();
-
-            return NNG_OK;
+            return _Start_async_dispatch(parallel);
         }
 
         int start_dispatch(
             std::string_view addr,
             int flags = 0) noexcept(false)
+        {
+            return start_dispatch(addr, flags, (size_t)1);
+        }
+
+        // 以多个并发工作项启动异步调度
+        // 参数：addr - 服务监听或连接的地址，flags - 启动标志，parallel - 并发工作项数
+        // 返回：操作结果，0 表示成功，非 0 表示失败
+        // 异常：若基类启动失败或 Aio / Ctx 创建失败，可能抛出 Exception
+        // 说明：
+        // - 处理回调在 nng 的工作线程中被并发调用，须自行保证线程安全
+        // - Pull、Pair 等协议在套接字上同时挂起多个接收，消息的处理顺序不再保证
+        // - 不支持 Ctx 的带返回协议只能使用一个工作项
+        int start_dispatch(
+            std::string_view addr,
+            int flags,
+            size_t parallel) noexcept(false)
         {
             int rv = _TyBase::start(addr, flags);
             if (rv != NNG_OK) {
                 return rv;
             }
 
-            // 创建 aio 对象用于异步调度
-            _My_aio = std::make_unique<Aio>(_Aio_callback, this);
-            if (!_My_aio) {
-                return NNG_ENOMEM;
-            }
-
             // 开始异步调度
-            _Start_async_dispatch();
+            return _Start_async_dispatch(parallel);
+        }
 
+        // 设置运行消息处理的执行器
+        // 参数：executor - 执行器，nullptr 表示在 nng 的 aio 回调线程中直接处理；不转移所有权，须比当前对象存活更久
+        // 返回：操作结果，0 表示成功；NNG_EBUSY 表示已经启动
+        // 说明：须在 start_dispatch 之前调用；执行器拒绝任务时退回在 aio 回调线程中处理
+        int set_executor(Executor* executor) noexcept
+        {
+            if (!_My_work_items.empty()) {
+                return NNG_EBUSY;
+            }
+            _My_executor = executor;
             return NNG_OK;
         }
 
@@ -82,11 +116,17 @@ namespace nng
         }
 
         // 停止异步调度
-        // 返回：true 表示成功停止，false 表示已经停止
-        // 说明：调用基类的 close 方法关闭连接器，并停止异步调度
+        // 返回：true 表示成功停止，false 表示已经停止，或在执行器的工作线程中调用而被拒绝
+        // 说明：
+        // - 调用基类的 close 方法关闭连接器，并停止全部工作项
+        // - 使用执行器时阻塞等待已转交的消息处理结束，因此不得在执行器的工作线程（包括处理回调）中调用或析构
         bool stop_dispatch() noexcept
         {
-            if (!_My_running.load()) {
+            if (_My_work_items.empty()) {
+                return false;
+            }
+            if (_My_executor && _My_executor->in_worker()) {
+                // 等待的消息处理可能正是当前线程，会死锁
                 return false;
             }
 
@@ -94,122 +134,196 @@ namespace nng
             _My_running.store(false);
 
             // 取消当前的 aio 操作
-            if (_My_aio) {
-                _My_aio->cancel();
+            for (auto& _Work_item : _My_work_items) {
+                _Work_item->_Aio.cancel();
             }
 
             // 关闭基类连接器
             _TyBase::close();
 
-            // 清理 aio 对象
-            _My_aio.reset();
+            // 等待已转交给执行器的消息处理结束（阻塞等待计数归零，不占用 CPU）
+            for (size_t _Count = _My_offloaded.load(); _Count != 0; _Count = _My_offloaded.load()) {
+                _My_offloaded.wait(_Count);
+            }
+
+            // 等待工作通道处理完已入队的消息
+            if constexpr (std::is_base_of_v<DispatcherNoReturn, _TyBase>) {
+                _TyBase::_Drain_key_ordered();
+            }
+
+            // 清理工作项（等待回调结束）
+            _My_work_items.clear();
 
             return true;
         }
 
         // 等待异步调度完成
-        // 说明：等待当前正在进行的异步操作完成
+        // 说明：等待各工作项当前正在进行的异步操作完成
         void service_wait() noexcept
         {
-            if (_My_aio) {
-                _My_aio->wait();
+            for (auto& _Work_item : _My_work_items) {
+                _Work_item->_Aio.wait();
             }
         }
     protected:
         // 开始异步调度
+        // 参数：parallel - 并发工作项数，0 按 1 处理
+        // 返回：操作结果，0 表示成功；_On_dispatch_ctx 失败时关闭连接器并返回其错误码
+        // 异常：若 Aio 或 Ctx 创建失败，抛出 Exception
         // 说明：启动异步消息接收循环
-        void _Start_async_dispatch() noexcept
+        int _Start_async_dispatch(size_t parallel = 1) noexcept(false)
         {
+            if constexpr (std::is_base_of_v<DispatcherWithReturn, _TyBase> && !_TyBase::_Dispatch_with_ctx) {
+                parallel = 1;
+            }
+            if constexpr (std::is_base_of_v<DispatcherNoReturn, _TyBase>) {
+                // 工作通道的队列只允许一个生产者
+                if (_TyBase::key_ordered()) {
+                    parallel = 1;
+                }
+            }
+            parallel = (std::max)(parallel, (size_t)1);
+            bool _Use_ctx = parallel > 1 && _TyBase::_Dispatch_with_ctx;
+
+            _My_work_items.reserve(parallel);
+            for (size_t i = 0; i < parallel; ++i) {
+                auto& _Work_item = _My_work_items.emplace_back(std::make_unique<WORK_ITEM>(_Aio_callback, this));
+                if (_Use_ctx) {
+                    _Work_item->_Ctx.emplace(_TyBase::Socket::get());
+                    int rv = this->_On_dispatch_ctx(*_Work_item->_Ctx);
+                    if (rv != NNG_OK) {
+                        _TyBase::close();
+                        _My_work_items.clear();
+                        return rv;
+                    }
+                }
+            }
+
             _My_running.store(true);
-            _Receive_next();
+            for (auto& _Work_item : _My_work_items) {
+                _Receive_next(*_Work_item);
+            }
+            return NNG_OK;
         }
 
         // 接收下一条消息
+        // 参数：_Work_item - 工作项
         // 说明：异步接收消息并设置回调
-        void _Receive_next() noexcept
+        void _Receive_next(WORK_ITEM& _Work_item) noexcept
         {
-            if (!_My_running.load() || !_My_aio) {
+            if (!_My_running.load()) {
                 return;
             }
 
-            try {
-                // 使用 aio 异步接收消息
-                _TyBase::recv(*_My_aio);
+            // 使用 aio 异步接收消息
+            if (_Work_item._Ctx) {
+                _Work_item._Ctx->recv(_Work_item._Aio);
             }
-            catch (const Exception& e) {
-                // 处理接收异常
-                if (this->_On_dispatch_exception(e)) {
-                    _My_running.store(false);
-                }
-                else {
-                    // 继续尝试接收
-                    _Receive_next();
-                }
+            else {
+                _TyBase::recv(_Work_item._Aio);
             }
         }
     private:
         // Aio 回调函数
-        // 参数：arg - 回调上下文（ServiceAio 对象指针）
+        // 参数：arg - 回调上下文（工作项指针）
         // 说明：处理异步接收完成的事件
         static void _Aio_callback(void* arg) noexcept
         {
-            auto* pService = static_cast<ServiceAio*>(arg);
-            if (!pService) {
+            auto* _Work_item = static_cast<PWORK_ITEM>(arg);
+            if (!_Work_item) {
                 assert(false);
                 return;
             }
 
-            pService->_Do_callback();
+            _Work_item->_Owner->_Do_callback(*_Work_item);
         }
         // Aio 回调处理函数
+        // 参数：_Work_item - 完成操作的工作项
         // 说明：检查 aio 结果，处理消息或错误，并继续接收
-        void _Do_callback() noexcept
+        void _Do_callback(WORK_ITEM& _Work_item) noexcept
         {
+            Aio& _Aio = _Work_item._Aio;
+
             // 检查 aio 操作结果
-            if (_My_aio->result() != NNG_OK) {
-                // 处理接收错误
-                if (this->_On_dispatch_exception({ _My_aio->result(), "recv_aio" })) {
+            if (_Aio.result() != NNG_OK) {
+                // 处理接收错误（超时等可继续的错误不构造异常）
+                if (this->_On_dispatch_error(_Aio.result())) {
                     _My_running.store(false);
                     return;
                 }
+                _Receive_next(_Work_item);
             }
             else {
-                // 获取接收到的消息
-                Msg m = _My_aio->get_msg();
+                // 获取接收到的消息（回复发送完成后为空）
+                Msg m = _Aio.release_msg();
                 if (m) {
-                    // 处理消息
-                    if (!this->_On_raw_message(m)) {
-                        auto code = Msg::_Chop_msg_code(m);
-                        auto result = this->_On_message(code, m);
-
-                        // 如果基类是 DispatcherWithReturn，则附加处理结果
-                        if constexpr (std::is_base_of_v<DispatcherWithReturn, _TyBase>) {
-                            Msg::_Append_msg_result(m, result);
+                    if (_My_executor) {
+                        // 转交给执行器处理，回复或继续接收由执行器线程发起
+                        _My_offloaded.fetch_add(1);
+                        Executor::Task _Task([this, &_Work_item, m = std::move(m)]() mutable {
+                            _Handle_message(_Work_item, m);
+                            if (_My_offloaded.fetch_sub(1) == 1) {
+                                _My_offloaded.notify_all();
+                            }
+                        });
+                        if (_My_executor->post(std::move(_Task)) != NNG_OK) {
+                            _Task();
                         }
                     }
-
-                    if (_My_running.load()) {
-                        if constexpr (std::is_base_of_v<DispatcherWithReturn, _TyBase>) {
-                            // 如果需要回复，则发送回复消息
-                            _My_aio->set_msg(std::move(m));
-                            _TyBase::send(*_My_aio);
-                        }
-                        else {
-                            // 否则继续接收下一条消息
-                            _Receive_next();
-                        }
+                    else {
+                        _Handle_message(_Work_item, m);
                     }
                 }
                 else {
                     // 消息为空，继续接收下一条
-                    if (_My_running.load()) {
-                        _Receive_next();
+                    _Receive_next(_Work_item);
+                }
+            }
+        }
+
+        // 处理接收到的消息，然后回复或继续接收
+        // 参数：_Work_item - 接收消息的工作项，m - 接收到的消息
+        void _Handle_message(WORK_ITEM& _Work_item, Msg& m) noexcept
+        {
+            Aio& _Aio = _Work_item._Aio;
+
+            // 处理消息
+            if constexpr (std::is_base_of_v<DispatcherWithReturn, _TyBase>) {
+                // 如果基类是 DispatcherWithReturn，则附加处理结果
+                if (!this->_On_raw_message(m)) {
+                    auto code = Msg::_Chop_msg_code(m);
+                    auto result = this->_On_message(code, m);
+                    Msg::_Append_msg_result(m, result);
+                }
+            }
+            else {
+                // 由 DispatcherNoReturn 处理，其中包括拆分合并消息；拆分出错且 _On_dispatch_error 要求停止时不再接收
+                if (this->_On_recv(m, _Work_item._Ctx ? &*_Work_item._Ctx : nullptr)) {
+                    _My_running.store(false);
+                }
+            }
+
+            if (_My_running.load()) {
+                if constexpr (std::is_base_of_v<DispatcherWithReturn, _TyBase>) {
+                    // 如果需要回复，则在接收所在的上下文上发送回复消息
+                    _Aio.set_msg(std::move(m));
+                    if (_Work_item._Ctx) {
+                        _Work_item._Ctx->send(_Aio);
                     }
+                    else {
+                        _TyBase::send(_Aio);
+                    }
+                }
+                else {
+                    // 否则继续接收下一条消息
+                    _Receive_next(_Work_item);
                 }
             }
         }
     private:
-        std::unique_ptr<Aio> _My_aio;           // 异步 I/O 对象
+        std::vector<std::unique_ptr<WORK_ITEM>> _My_work_items;    // 工作项，std::unique_ptr 保证回调上下文地址不变
         std::atomic<bool> _My_running{false};   // 运行状态标志
+        Executor* _My_executor = nullptr;       // 运行消息处理的执行器，为空时在 aio 回调线程中处理
+        std::atomic<size_t> _My_offloaded{0};   // 已转交给执行器尚未结束的消息处理数
     };
-} 
\ No newline at end of file
+}
@@ -3,6 +3,7 @@
 #include "nngException.h"
 #include "nngMsg.h"
 #include "nngSocketOpt.h"
+#include "nngAwaitable.h"
 
 namespace nng
 {
@@ -73,6 +74,12 @@ namespace nng
         void recv(nng_aio* aio) noexcept {
             nng_recv_aio(_My_socket, aio);
         }
+        // 协程接收消息：co_await sock.async_recv()
+        // 返回：协程等待对象，co_await 得到接收到的 Msg 对象，接收失败时抛出 Exception
+        // 异常：若 Aio 分配失败，抛出 Exception
+        RecvAwaitable async_recv() noexcept(false) {
+            return RecvAwaitable(_My_socket);
+        }
         // 同步发送数据
         // 参数：data - 数据指针，data_size - 数据大小
         // 返回：操作结果，0 表示成功
@@ -185,11 +192,11 @@ namespace nng
             return Msg(msg);
         }
         // 同步接收消息到指定对象
-        // 参数：msg - 存储接收消息的 Msg 对象
+        // 参数：msg - 存储接收消息的 Msg 对象，flags - 接收标志，默认为 0
         // 返回：操作结果，0 表示成功
-        int recv(Msg& msg) noexcept {
+        int recv(Msg& msg, int flags = 0) noexcept {
             nng_msg* m = nullptr;
-            int rv = nng_recvmsg(_My_socket, &m, 0);
+            int rv = nng_recvmsg(_My_socket, &m, flags);
             if (rv != NNG_OK) {
                 return rv;
             }
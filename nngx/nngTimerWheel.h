@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "nngException.h"
+
+namespace nng
+{
+    // TimerWheel 类：哈希时间轮，管理大量一次性定时器
+    // 用途：为排队中的消息项等大量对象提供截止时间检查，添加和到期处理均摊为 O(1)
+    // 特性：
+    // - 时间按 tick 毫秒划分，定时器按到期 tick 哈希到环形槽中，槽数向上取整为 2 的幂
+    // - 截止时间超过一圈的定时器留在槽中，直到真正到期
+    // - 不支持删除：已完成对象的定时器到期时由调用方自行忽略
+    // - 非线程安全，由调用方加锁保护
+    template <typename T>
+    class TimerWheel
+    {
+        typedef struct _ENTRY
+        {
+            nng_time _Deadline;
+            T _Value;
+        } ENTRY, * PENTRY;
+
+    public:
+        // 构造函数：创建时间轮
+        // 参数：slots - 槽数量，向上取整为 2 的幂；tick - 每个槽代表的时间（毫秒）
+        // 异常：若分配失败，抛出 std::bad_alloc
+        explicit TimerWheel(size_t slots = 512, nng_duration tick = 10) noexcept(false)
+            : _My_tick(tick > 0 ? (uint64_t)tick : 1) {
+            size_t _Size = 2;
+            while (_Size < slots) {
+                _Size <<= 1;
+            }
+            _My_buckets.resize(_Size);
+            _My_mask = _Size - 1;
+            _My_current = nng_clock() / _My_tick;
+        }
+
+        // 添加定时器
+        // 参数：deadline - 绝对截止时间（nng_clock 毫秒），value - 到期时交给回调的值
+        // 异常：若分配失败，抛出 std::bad_alloc
+        // 说明：已过期的定时器放入当前槽，下一次推进时立即到期
+        void add(nng_time deadline, const T& value) noexcept(false) {
+            uint64_t _Tick = deadline / _My_tick;
+            if (_Tick < _My_current) {
+                _Tick = _My_current;
+            }
+            _My_buckets[_Tick & _My_mask].push_back({ deadline, value });
+            ++_My_size;
+        }
+
+        // 推进时间轮，处理所有已到期的定时器
+        // 参数：now - 当前时间（nng_clock 毫秒），fn - 到期回调，以定时器的值调用
+        // 返回：到期的定时器数量
+        // 说明：先摘下全部到期定时器再逐个回调，回调中可以安全地添加新的定时器
+        template <typename _Fn_t>
+        size_t expire(nng_time now, _Fn_t&& fn) noexcept(false) {
+            uint64_t _Target = now / _My_tick;
+            uint64_t _Steps = _Target >= _My_current ? _Target - _My_current + 1 : 1;
+            if (_Steps > _My_buckets.size()) {
+                // 跨度超过一圈时每个槽只需检查一次
+                _Steps = _My_buckets.size();
+            }
+
+            _My_expired.clear();
+            for (uint64_t i = 0; i < _Steps; ++i) {
+                auto& _Bucket = _My_buckets[(_My_current + i) & _My_mask];
+                for (size_t j = 0; j < _Bucket.size();) {
+                    if (_Bucket[j]._Deadline <= now) {
+                        _My_expired.push_back(std::move(_Bucket[j]._Value));
+                        _Bucket[j] = std::move(_Bucket.back());
+                        _Bucket.pop_back();
+                    }
+                    else {
+                        ++j;
+                    }
+                }
+            }
+            if (_Target > _My_current) {
+                _My_current = _Target;
+            }
+
+            _My_size -= _My_expired.size();
+            for (auto& _Value : _My_expired) {
+                fn(_Value);
+            }
+            return _My_expired.size();
+        }
+
+        // 检查时间轮中是否没有定时器
+        // 返回：true 表示为空
+        bool empty() const noexcept {
+            return _My_size == 0;
+        }
+
+        // 获取时间轮中的定时器数量
+        // 返回：定时器数量
+        size_t size() const noexcept {
+            return _My_size;
+        }
+
+        // 获取每个槽代表的时间
+        // 返回：tick（毫秒）
+        nng_duration tick() const noexcept {
+            return (nng_duration)_My_tick;
+        }
+
+    private:
+        std::vector<std::vector<ENTRY>> _My_buckets;
+        std::vector<T> _My_expired;     // 本次推进到期的值，复用以避免反复分配
+        uint64_t _My_tick;
+        uint64_t _My_current = 0;       // 已推进到的 tick
+        size_t _My_mask = 0;
+        size_t _My_size = 0;
+    };
+}
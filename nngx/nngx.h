@@ -1,8 +1,12 @@
 ﻿#pragma once
 
 #include <list>
+#include <algorithm>
+#include <deque>
 #include <mutex>
 #include <queue>
+#include <vector>
+#include <thread>
 #include <future>
 #include <optional>
 
@@ -16,6 +20,14 @@
 #include "nngServiceAio.h"
 #include "nngAsyncContext.h"
 #include "nngDispatcher.h"
+#include "nngQueue.h"
+#include "nngInplaceFunction.h"
+#include "nngAwaitable.h"
+#include "nngTimerWheel.h"
+#include "nngExecutor.h"
+#include "nngRouter.h"
+#include "nngMsgReader.h"
+#include "nngMsgWriter.h"
 
 /*
 __________
@@ -42,6 +54,32 @@ __________
             -> 1. Add the ServiceAio class to use nng_aio instead of thread to implement async dispatch
             -> 2. Adjust the file directory structure
             -> 3. Optimise the code structure of Dispatcher...
+        -- Modify.Beacon.20261017
+            -> 1. Add AsyncSenderWithReturn::set_parallel to pipeline requests over a pool of Ctx + Aio
+            -> 2. Add MpscQueue and AsyncSender::set_lock_free to submit messages without a mutex
+            -> 3. Add AsyncSender::set_queue_limit to bound the send queue by messages/bytes with back-pressure policies
+            -> 4. Add AsyncSenderNoReturn::async_send_batch to submit a burst of messages with one synchronization
+            -> 5. Add AsyncSenderNoReturn::set_send_parallel to drain the send queue with several send aios
+            -> 6. Add InplaceFunction and AsyncSenderWithReturn::async_send overloads with an allocation-free reply callback
+            -> 7. Add C++20 coroutine awaitables: Socket/Ctx::async_recv, Request::async_call and Survey::async_collect
+            -> 8. Add TimerWheel and per-request deadlines/cancellation to AsyncSenderWithReturn
+            -> 9. Add priority lanes (strict / weighted) to AsyncSender
+            -> 10. Add Nagle-style small message coalescing to AsyncSenderNoReturn, unpacked by DispatcherNoReturn
+            -> 11. Rework Dispatcher::dispatch around error codes, add _On_dispatch_error
+            -> 12. Add multi-threaded Service dispatch, one Ctx per thread for Rep / Respondent / Sub
+            -> 13. Add a pool of concurrent Ctx + Aio work items to ServiceAio
+            -> 14. Generalize ResponseParallel into ContextParallel<Protocol, Connector> for Rep / Respondent / Sub / Req
+            -> 15. Add ContextParallel::ReplyToken and _Defer_reply to complete replies from any thread
+            -> 16. Add ContextParallel::set_autoscale and the _On_autoscale policy hook
+            -> 17. Add Executor / work-stealing ThreadPool and set_executor to run ServiceAio / ContextParallel handlers off the aio threads
+            -> 18. Add SpscQueue and DispatcherNoReturn::set_key_ordered for key-ordered parallel dispatch
+            -> 19. Add DispatcherNoReturn::set_batch and the _On_batch hook to drain receives without blocking
+            -> 20. Add compile-time Router / Handler and the runtime RouteMap for message code routing
+            -> 21. Add MsgPool to recycle nng_msg by size class with thread-local caches
+            -> 22. Add MsgReader, a non-mutating zero-copy cursor over message bodies
+            -> 23. Add MsgWriter, which grows a message body once and encodes fields in place
+            -> 24. Add Pod / Schema compile-time struct codecs and the *_pod functions on Msg, MsgReader and MsgWriter
+            -> 25. Add ByteOrder with SSSE3 / AVX2 bulk byte swapping and the *_array functions on Msg, MsgReader and MsgWriter
 */
 
 /*
@@ -52,10 +90,16 @@ __________
         virtual void _On_sender_recv(MSG_ITEM& _Msg_item, Msg& m) noexcept;
 
         virtual void _On_close(PWORK_ITEM _Work_item);
+        virtual int _On_dispatch_ctx(const Ctx& ctx);
+        virtual bool _On_dispatch_error(nng_err e);
+        virtual void _On_request_failed(Msg::_Ty_msg_code code, Msg& request, nng_err e);
+        virtual uint64_t _On_dispatch_key(const Msg& msg);
+        virtual void _On_batch(std::span<Msg> msgs);
         virtual bool _On_raw_message(Msg& msg);
         virtual bool _On_raw_message(Msg& msg, nng_duration& _Wait_ms);
         virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg);
         virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg, nng_duration& _Wait_ms);
+        virtual void _On_reply(Msg::_Ty_msg_code code, Msg::_Ty_msg_result res, Msg& msg, nng_duration& _Wait_ms);
         virtual void _On_wait(nng_duration& _Wait_ms);
 */
 
@@ -130,9 +174,13 @@ namespace nng
     // 用途：实现 Rep 协议的消息接收和回复
     // 特性：
     // - 使用 Listener 连接器
-    // - 提供带返回的消息分发
+    // - 提供带返回的消息分发，支持在多个 Ctx 上并行分发
     class Response : public Peer<Listener>, virtual public Socket, public DispatcherWithReturn
     {
+    public:
+        static constexpr bool _Dispatch_with_ctx = true;
+
+    private:
         // 创建 Rep 协议套接字
         // 返回：操作结果，0 表示成功
         virtual int _Create() noexcept override {
@@ -145,6 +193,8 @@ namespace nng
     // 特性：
     // - 使用 Dialer 连接器
     // - 提供带返回的异步发送
+    // - start 之后调用 set_parallel 可开启流水线模式，多个请求同时在途
+    // - 提供协程接口 async_call，每次调用使用独立的 Ctx
     class Request : public Peer<Dialer>, virtual public Socket, public AsyncSenderWithReturn
     {
         // 创建 Req 协议套接字
@@ -188,6 +238,22 @@ namespace nng
 
             return req.send(code, msg);
         }
+
+        // 协程发送请求并接收回复：co_await req.async_call(msg)
+        // 参数：msg - 请求消息
+        // 返回：协程等待对象，co_await 得到回复的 Msg 对象；每次调用使用独立的 Ctx，可大量同时在途
+        // 异常：若 Ctx 或 Aio 创建失败，抛出 Exception；发送或接收失败时 co_await 抛出 Exception
+        CallAwaitable async_call(Msg&& msg) noexcept(false) {
+            return CallAwaitable(Socket::get(), std::move(msg));
+        }
+
+        // 协程发送带消息代码的请求并接收结果：co_await req.async_call(code, msg)
+        // 参数：code - 消息代码，msg - 请求消息，co_await 结束后被替换为回复消息（须保持有效）
+        // 返回：协程等待对象，co_await 得到消息结果
+        // 异常：若 Ctx、Aio 创建或消息分配失败，抛出 Exception；发送或接收失败时 co_await 抛出 Exception
+        CallCodeAwaitable async_call(Msg::_Ty_msg_code code, Msg& msg) noexcept(false) {
+            return CallCodeAwaitable(Socket::get(), code, msg);
+        }
     };
 
 }
@@ -213,10 +279,14 @@ namespace nng
     // 用途：实现 Sub 协议的异步消息订阅
     // 特性：
     // - 支持 Listener 或 Dialer 连接器
-    // - 提供无返回的消息分发
+    // - 提供无返回的消息分发，支持在多个 Ctx 上并行分发（订阅属于各个 Ctx，见 _On_dispatch_ctx）
     template <class _Connector_t = Dialer>
     class Subscriber : public Peer<_Connector_t>, virtual public Socket, public DispatcherNoReturn
     {
+    public:
+        static constexpr bool _Dispatch_with_ctx = true;
+
+    private:
         // 创建 Sub 协议套接字
         // 返回：操作结果，0 表示成功
         virtual int _Create() noexcept override {
@@ -233,6 +303,7 @@ namespace nng
     // 特性：
     // - 支持 Listener 或 Dialer 连接器
     // - 提供带返回的异步发送
+    // - 提供协程接口 async_collect，每次调查使用独立的 Ctx
     template <class _Connector_t = Listener>
     class Survey : public Peer<_Connector_t>, virtual public Socket, public AsyncSenderWithReturn
     {
@@ -279,16 +350,37 @@ namespace nng
             Msg::_Append_msg_code(msg, code);
             return send(std::move(msg), iter);
         }
+
+        // 协程发送调查并收集回复：co_await survey.async_collect(msg)
+        // 参数：msg - 调查消息，max_replies - 最多收集的回复数，收满后立即返回
+        // 返回：协程等待对象，co_await 得到回复消息列表（调查时间到期或收满时结束）
+        // 异常：若 Ctx 或 Aio 创建失败，抛出 Exception；发送失败或接收出现超时以外的错误时 co_await 抛出 Exception
+        CollectAwaitable async_collect(Msg&& msg, size_t max_replies = (std::numeric_limits<size_t>::max)()) noexcept(false) {
+            return CollectAwaitable(Socket::get(), std::move(msg), max_replies);
+        }
+
+        // 协程发送带消息代码的调查并收集回复：co_await survey.async_collect(code, msg)
+        // 参数：code - 消息代码，msg - 调查消息，max_replies - 最多收集的回复数
+        // 返回：协程等待对象，co_await 得到回复消息列表
+        // 异常：同 async_collect(msg, max_replies)
+        CollectAwaitable async_collect(Msg::_Ty_msg_code code, Msg&& msg, size_t max_replies = (std::numeric_limits<size_t>::max)()) noexcept(false) {
+            Msg::_Append_msg_code(msg, code);
+            return CollectAwaitable(Socket::get(), std::move(msg), max_replies);
+        }
     };
 
     // Respond 类：Respondent 协议的模板类，继承 Peer 和 DispatcherWithReturn
     // 用途：实现 Respondent 协议的消息接收和回复
     // 特性：
     // - 支持 Listener 或 Dialer 连接器
-    // - 提供带返回的消息分发
+    // - 提供带返回的消息分发，支持在多个 Ctx 上并行分发
     template <class _Connector_t = Dialer>
     class Respond : public Peer<_Connector_t>, virtual public Socket, public DispatcherWithReturn
     {
+    public:
+        static constexpr bool _Dispatch_with_ctx = true;
+
+    private:
         // 创建 Respondent 协议套接字
         // 返回：操作结果，0 表示成功
         virtual int _Create() noexcept override {
@@ -337,18 +429,59 @@ namespace nng
 
 namespace nng
 {
-    // ResponseParallel 类：并行 Rep 协议类，继承 Peer 和 DispatcherWithReturn
-    // 用途：实现 Rep 协议的并行消息处理，支持多个工作项
+    // ContextParallel 工作项的收发方式
+    enum CONTEXT_MODE
+    {
+        CM_REPLY,       // 接收 -> 处理 -> 回复（Rep、Respondent）
+        CM_RECV,        // 接收 -> 处理，不回复（Sub）
+        CM_REQUEST      // 发送请求 -> 接收回复 -> 处理（Req）
+    };
+
+    // ContextParallel 的协议特性：_Open - 打开套接字的函数，_Mode - 工作项的收发方式
+    struct ProtocolRep
+    {
+        static int _Open(nng_socket* s) noexcept { return nng_rep0_open(s); }
+        static constexpr CONTEXT_MODE _Mode = CM_REPLY;
+    };
+
+    struct ProtocolRespondent
+    {
+        static int _Open(nng_socket* s) noexcept { return nng_respondent0_open(s); }
+        static constexpr CONTEXT_MODE _Mode = CM_REPLY;
+    };
+
+    struct ProtocolSub
+    {
+        static int _Open(nng_socket* s) noexcept { return nng_sub0_open(s); }
+        static constexpr CONTEXT_MODE _Mode = CM_RECV;
+    };
+
+    struct ProtocolReq
+    {
+        static int _Open(nng_socket* s) noexcept { return nng_req0_open(s); }
+        static constexpr CONTEXT_MODE _Mode = CM_REQUEST;
+    };
+
+    // ContextParallel 类：基于 Ctx 的并行协议模板类，继承 Peer 和 Dispatcher
+    // 用途：通过多个工作项（WORK_ITEM，每个包含 Ctx + Aio）并行处理消息
     // 特性：
-    // - 使用 Listener 连接器
-    // - 通过多个工作项（WORK_ITEM）并行处理消息
-    // - 提供带返回的消息分发
-    class ResponseParallel : public Peer<Listener>, virtual public Socket, public DispatcherWithReturn
+    // - 协议由 _Protocol_t（ProtocolRep / ProtocolRespondent / ProtocolSub / ProtocolReq）指定，支持 Listener 或 Dialer 连接器
+    // - Rep、Respondent：接收 -> _On_message -> 回复，提供带返回的消息分发
+    // - Sub：接收 -> _On_message，不回复；订阅属于各个 Ctx，须在 _On_dispatch_ctx 中订阅
+    // - Req：async_send 提交的请求由空闲工作项发送，回复以 (请求的消息代码, 结果, 回复消息) 交给 _On_reply，实现客户端流水线
+    // - Req：发送失败或未收到回复（如 Ctx 的接收超时）的请求逐个以消息代码交给 _On_request_failed
+    // - 处理回调可通过 _Wait_ms 要求工作项异步等待后再继续（_On_wait）
+    // - Rep、Respondent 的处理回调可通过 _Defer_reply 取得回复令牌，稍后在任意线程完成回复，无需轮询
+    // - Rep、Respondent、Sub 支持通过 set_autoscale 在上下限之间自动增减活动的工作项，扩缩策略可由 _On_autoscale 定制
+    // - 可通过 set_executor 把处理回调转交给执行器（如 ThreadPool）运行，回复在处理完成后由执行器线程发起
+    template <typename _Protocol_t, class _Connector_t = Listener>
+    class ContextParallel : public Peer<_Connector_t>, virtual public Socket,
+        public std::conditional_t<_Protocol_t::_Mode == CM_REPLY, DispatcherWithReturn, DispatcherNoReturn>
     {
-        // 创建 Rep 协议套接字
+        // 创建协议套接字
         // 返回：操作结果，0 表示成功
         virtual int _Create() noexcept override {
-            return Socket::create(nng_rep0_open);
+            return Socket::create(_Protocol_t::_Open);
         }
 
     protected:
@@ -365,6 +498,11 @@ namespace nng
             Ctx _Ctx;
             Msg _Msg;
             void* _Owner;
+            std::atomic<int> _Defer{ 0 };   // 延迟回复状态（DEFER_STATE）
+            nng_time _Recv_time = 0;        // 自动扩缩模式下本次开始接收的时间
+            Msg _Reply;                     // 处理回调返回前令牌已完成时暂存的回复
+            bool _Reply_send = false;       // 暂存的完成方式：true 发送回复，false 放弃回复
+            Msg::_Ty_msg_code _Request_code = 0;    // Req 协议在途请求的消息代码，随回复交给 _On_reply，失败时交给 _On_request_failed
 
             // 工作项构造函数
             // 参数：socket - 套接字，callback - 回调函数，owner - 父对象
@@ -387,6 +525,12 @@ namespace nng
                 _Ctx.send(_Aio);
             }
 
+            // 异步接收消息
+            inline void recv() noexcept {
+                _State = WIS_RECV;
+                _Ctx.recv(_Aio);
+            }
+
             // 异步等待
             // 参数：ms - 等待时间（毫秒）
             inline void wait(nng_duration ms) noexcept {
@@ -395,28 +539,195 @@ namespace nng
             }
         } WORK_ITEM, * PWORK_ITEM;
 
+        // 延迟回复状态
+        enum DEFER_STATE
+        {
+            DS_NONE,        // 未延迟
+            DS_PENDING,     // 处理回调中已取得令牌，回调尚未返回
+            DS_DETACHED,    // 处理回调已返回，等待令牌完成
+            DS_DONE         // 处理回调返回前令牌已完成，回复暂存在工作项中
+        };
+
+        // 自动扩缩的决策依据，交给 _On_autoscale
+        typedef struct _AUTOSCALE_STATS
+        {
+            enum
+            {
+                AE_RECV,                // 工作项收到一条消息
+                AE_IDLE                 // 工作项在空闲时间内没有收到消息
+            } _Event;
+            size_t _Active;             // 活动的工作项数
+            size_t _Receiving;          // 正在等待消息的工作项数（不含触发事件的工作项）
+            size_t _Min;                // 工作项数下限
+            size_t _Max;                // 工作项数上限
+            nng_duration _Recv_wait;    // 触发事件的工作项本次等待消息的时间（毫秒），0 表示消息已在排队
+        } AUTOSCALE_STATS, * PAUTOSCALE_STATS;
+
+    public:
+        // ReplyToken 类：延迟回复令牌（仅 Rep、Respondent 协议）
+        // 用途：处理回调需要等待下游调用时，先取得令牌返回，稍后在任意线程以 reply 完成回复
+        // 特性：
+        // - 完成时立即在原 Ctx 上发送回复，延迟只取决于下游调用
+        // - 仅支持移动；未完成即销毁时放弃回复，工作项继续接收下一个请求
+        // - 令牌不得比 ContextParallel 对象存活更久
+        class ReplyToken
+        {
+        public:
+            // 构造函数：创建空令牌
+            ReplyToken() noexcept = default;
+
+            // 析构函数：未完成时放弃回复
+            ~ReplyToken() noexcept {
+                abandon();
+            }
+
+            // 禁用拷贝构造函数
+            ReplyToken(const ReplyToken&) = delete;
+
+            // 禁用拷贝赋值运算符
+            ReplyToken& operator=(const ReplyToken&) = delete;
+
+            // 移动构造函数：转移令牌
+            // 参数：other - 源令牌，移动后为空
+            ReplyToken(ReplyToken&& other) noexcept
+                : _My_owner(std::exchange(other._My_owner, nullptr)), _My_item(std::exchange(other._My_item, nullptr)) {
+            }
+
+            // 移动赋值运算符：转移令牌，当前令牌未完成时先放弃回复
+            // 参数：other - 源令牌，移动后为空
+            // 返回：当前对象的引用
+            ReplyToken& operator=(ReplyToken&& other) noexcept {
+                if (this != &other) {
+                    abandon();
+                    _My_owner = std::exchange(other._My_owner, nullptr);
+                    _My_item = std::exchange(other._My_item, nullptr);
+                }
+                return *this;
+            }
+
+            // 完成回复
+            // 参数：msg - 回复消息，result - 附加在回复末尾的处理结果
+            // 说明：可在任意线程调用，只能调用一次，之后令牌为空
+            void reply(Msg&& msg, Msg::_Ty_msg_result result = {}) noexcept {
+                if (!_My_item) {
+                    return;
+                }
+                if (msg || msg.realloc(0) == NNG_OK) {
+                    Msg::_Append_msg_result(msg, result);
+                    std::exchange(_My_owner, nullptr)->_Finish_deferred(std::exchange(_My_item, nullptr), std::move(msg), true);
+                }
+                else {
+                    abandon();
+                }
+            }
+
+            // 放弃回复，工作项继续接收下一个请求
+            void abandon() noexcept {
+                if (_My_item) {
+                    std::exchange(_My_owner, nullptr)->_Finish_deferred(std::exchange(_My_item, nullptr), Msg(), false);
+                }
+            }
+
+            // 检查令牌是否尚未完成
+            // 返回：true 表示尚未完成
+            explicit operator bool() const noexcept {
+                return _My_item != nullptr;
+            }
+
+        private:
+            friend class ContextParallel;
+
+            // 构造函数：绑定工作项
+            // 参数：owner - 父对象，item - 工作项
+            ReplyToken(ContextParallel* owner, PWORK_ITEM item) noexcept : _My_owner(owner), _My_item(item) {
+            }
+
+        private:
+            ContextParallel* _My_owner = nullptr;
+            PWORK_ITEM _My_item = nullptr;
+        };
+
     public:
+        // 析构函数：关闭套接字，不再接收新的消息，再等待已转交给执行器的处理回调结束
+        // 说明：
+        // - 使用执行器时不得在执行器的工作线程中析构
+        // - 此时派生类的成员已经销毁，处理回调不能再访问它们；使用执行器时须先在派生类析构之前调用 close（调试版断言）
+        virtual ~ContextParallel() {
+            assert(!_My_executor || _My_work_items.empty() || !Socket::valid());
+            Peer<_Connector_t>::close();
+            _Wait_offloaded();
+        }
+
+        // 关闭套接字，并等待已转交给执行器的处理回调结束
+        // 说明：使用执行器时，须在派生类析构之前调用（如在派生类的析构函数中），且不得在执行器的工作线程（包括处理回调）中调用
+        void close() noexcept {
+            Peer<_Connector_t>::close();
+            _Wait_offloaded();
+        }
+
+        // 设置运行处理回调的执行器
+        // 参数：executor - 执行器，nullptr 表示在 nng 的 aio 回调线程中直接处理；不转移所有权，须比当前对象存活更久
+        // 返回：操作结果，0 表示成功；NNG_EBUSY 表示已经启动
+        // 说明：
+        // - 须在 start 之前调用
+        // - 执行器拒绝任务时退回在 aio 回调线程中处理
+        int set_executor(Executor* executor) noexcept {
+            if (!_My_work_items.empty()) {
+                return NNG_EBUSY;
+            }
+            _My_executor = executor;
+            return NNG_OK;
+        }
+
+        // 开启自动扩缩（仅 Rep、Respondent、Sub 协议）
+        // 参数：min_items - 活动工作项数下限（至少为 1），max_items - 上限，idle - 工作项空闲多久（毫秒）后可被回收
+        // 返回：操作结果，0 表示成功；NNG_EINVAL 表示参数无效；NNG_EBUSY 表示已经启动
+        // 说明：
+        // - 须在 start 之前调用，start 的 parallel 作为初始工作项数并被限制在上下限之间
+        // - 默认策略：全部工作项都在处理且消息已在排队时增加一个工作项；工作项空闲超过 idle 时回收，直至下限
+        // - 回收的工作项不再挂起接收，留待下次扩容时复用
+        int set_autoscale(size_t min_items, size_t max_items, nng_duration idle = 1000) noexcept requires (_Protocol_t::_Mode != CM_REQUEST) {
+            if (min_items == 0 || max_items < min_items || idle <= 0) {
+                return NNG_EINVAL;
+            }
+            if (!_My_work_items.empty()) {
+                return NNG_EBUSY;
+            }
+            _My_scale_min = min_items;
+            _My_scale_max = max_items;
+            _My_scale_idle = idle;
+            return NNG_OK;
+        }
+
+        // 获取活动的工作项数
+        // 返回：活动的工作项数（未开启自动扩缩时为 start 创建的数量）
+        size_t active_items() const noexcept {
+            return _My_active.load();
+        }
+
         // 启动并行处理
-        // 参数：addr - 监听地址，parallel - 并行工作项数量，flags - 启动标志
-        // 返回：操作结果，0 表示成功
+        // 参数：addr - 监听或连接地址，parallel - 并行工作项数量，flags - 启动标志
+        // 返回：操作结果，0 表示成功；_On_dispatch_ctx 失败时关闭套接字并返回其错误码
         // 异常：若创建或启动失败，抛出 Exception
         int start(std::string_view addr, size_t parallel = 1, int flags = 0) noexcept(false) {
-            int rv = _Create();
+            int rv = Peer<_Connector_t>::start(addr, flags);
             if (rv != NNG_OK) {
                 return rv;
             }
 
-            Peer<Listener>::_My_connector = std::make_unique<Listener>(*this, addr);
-            rv = Peer<Listener>::_My_connector->start(flags);
-            if (rv != NNG_OK) {
-                return rv;
+            if (_My_scale_max != 0) {
+                parallel = (std::clamp)(parallel, _My_scale_min, _My_scale_max);
             }
-
-            _My_work_items.reserve(parallel);
-
             for (size_t i = 0; i < parallel; ++i) {
-                _My_work_items.emplace_back(*this, _Callback, this);
+                auto& _Work_item_ref = _My_work_items.emplace_back(*this, _Callback, this);
+                rv = this->_On_dispatch_ctx(_Work_item_ref._Ctx);
+                if (rv != NNG_OK) {
+                    _My_work_items.clear();
+                    Peer<_Connector_t>::close();
+                    return rv;
+                }
             }
+            _My_active.store(parallel);
 
             for (auto& _Work_item_ref : _My_work_items) {
                 _Callback(&_Work_item_ref);
@@ -425,27 +736,83 @@ namespace nng
             return NNG_OK;
         }
 
+        // 异步发送请求（仅 Req 协议）
+        // 参数：code - 消息代码，msg - 要发送的 Msg 对象
+        // 返回：操作结果，0 表示成功
+        // 说明：有空闲工作项时立即发送，否则排队；回复交给 _On_reply(消息代码, 结果, 回复消息, _Wait_ms)，
+        //       发送失败或接收回复失败时交给 _On_request_failed(消息代码, 未发出的请求, 错误码)
+        int async_send(Msg::_Ty_msg_code code, Msg&& msg) noexcept requires (_Protocol_t::_Mode == CM_REQUEST) {
+            if (!msg) {
+                int rv = msg.realloc(0);
+                if (rv != NNG_OK) {
+                    return rv;
+                }
+            }
+            Msg::_Append_msg_code(msg, code);
+
+            PWORK_ITEM _Work_item = nullptr;
+            {
+                std::scoped_lock locker(_My_request_mtx);
+                if (_My_idle_items.empty()) {
+                    _My_requests.push_back(std::move(msg));
+                    return NNG_OK;
+                }
+                _Work_item = _My_idle_items.back();
+                _My_idle_items.pop_back();
+            }
+            _Send_request(_Work_item, std::move(msg));
+            return NNG_OK;
+        }
+
     protected:
+        // 在处理回调中取得延迟回复令牌（仅 Rep、Respondent 协议）
+        // 参数：msg - 处理回调收到的 Msg 对象，用于定位工作项
+        // 返回：回复令牌；处理回调的返回值和 _Wait_ms 将被忽略，回复由令牌完成
+        // 异常：若 msg 不是某个工作项正在处理的消息，抛出 Exception(NNG_EINVAL)
+        ReplyToken _Defer_reply(Msg& msg) noexcept(false) requires (_Protocol_t::_Mode == CM_REPLY) {
+            std::scoped_lock locker(_My_items_mtx);
+            for (auto& _Work_item_ref : _My_work_items) {
+                if (&_Work_item_ref._Msg == &msg) {
+                    _Work_item_ref._Defer.store(DS_PENDING);
+                    return ReplyToken(this, &_Work_item_ref);
+                }
+            }
+            throw Exception(NNG_EINVAL, "_Defer_reply");
+        }
+
         // 回调函数：处理工作项的异步操作
         // 参数：arg - 工作项指针
         static void _Callback(void* arg) noexcept {
             nng_err err;
             auto _Work_item = static_cast<PWORK_ITEM>(arg);
-            auto* _This = static_cast<ResponseParallel*>(_Work_item->_Owner);
+            auto* _This = static_cast<ContextParallel*>(_Work_item->_Owner);
 
             switch (_Work_item->_State) {
             case WORK_ITEM::WIS_RECV:
                 err = _Work_item->_Aio.result();
+                if constexpr (_Protocol_t::_Mode != CM_REQUEST) {
+                    if (_This->_My_scale_max != 0 && _This->_Autoscale(_Work_item, err)) {
+                        break;
+                    }
+                }
                 switch (err) {
                 case NNG_OK:
                     _Work_item->_Msg = _Work_item->_Aio.release_msg();
-                    _This->_On_message(_Work_item);
+                    _This->_Post_message(_Work_item);
                     break;
                 case NNG_ECLOSED:
                     _This->_On_close(_Work_item);
                     break;
                 default:
-                    _This->_On_exception(err);
+                    if constexpr (_Protocol_t::_Mode == CM_REQUEST) {
+                        // 回复未到达：按请求报告失败
+                        _This->_Request_failed(_Work_item, Msg(), err);
+                        _This->_Request_next(_Work_item);
+                    }
+                    else {
+                        _This->_On_exception(err);
+                        _This->_Recv(_Work_item);
+                    }
                     break;
                 }
                 break;
@@ -454,19 +821,44 @@ namespace nng
                 break;
             case WORK_ITEM::WIS_SEND:
                 err = _Work_item->_Aio.result();
-                switch (err) {
-                case NNG_OK:
-                    break;
-                case NNG_ECLOSED:
-                    _This->_On_close(_Work_item);
-                    break;
-                default:
-                    _This->_On_exception(err);
+                if constexpr (_Protocol_t::_Mode == CM_REQUEST) {
+                    // 请求已发出，在同一上下文上接收回复
+                    switch (err) {
+                    case NNG_OK:
+                        _Work_item->recv();
+                        break;
+                    case NNG_ECLOSED:
+                        _Work_item->_Aio.release_msg();
+                        _This->_On_close(_Work_item);
+                        break;
+                    default:
+                        // 发送失败：交回未发出的请求
+                        _This->_Request_failed(_Work_item, _Work_item->_Aio.release_msg(), err);
+                        _This->_Request_next(_Work_item);
+                        break;
+                    }
                     break;
                 }
+                else {
+                    switch (err) {
+                    case NNG_OK:
+                        break;
+                    case NNG_ECLOSED:
+                        _This->_On_close(_Work_item);
+                        break;
+                    default:
+                        _This->_On_exception(err);
+                        break;
+                    }
+                }
+                [[fallthrough]];
             case WORK_ITEM::WIS_INIT:
-                _Work_item->_State = WORK_ITEM::WIS_RECV;
-                _Work_item->_Ctx.recv(_Work_item->_Aio);
+                if constexpr (_Protocol_t::_Mode == CM_REQUEST) {
+                    _This->_Request_next(_Work_item);
+                }
+                else {
+                    _This->_Recv(_Work_item);
+                }
                 break;
             default:
                 _This->_On_exception(NNG_ESTATE);
@@ -492,19 +884,26 @@ namespace nng
         }
 
         // 虚函数：处理编码消息
-        // 参数：code - 消息代码，msg - 接收的 Msg 对象
-        // 返回：消息处理结果
+        // 参数：code - 消息代码（Req 协议为回复的结果，见 _On_reply），msg - 接收的 Msg 对象
+        // 返回：消息处理结果，仅 Rep、Respondent 协议作为回复的结果
         virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg) override {
             return {};
         }
 
         // 虚函数：处理编码消息并设置等待时间
-        // 参数：code - 消息代码，msg - 接收的 Msg 对象，_Wait_ms - 等待时间
-        // 返回：消息处理结果
+        // 参数：code - 消息代码（Req 协议为回复的结果，见 _On_reply），msg - 接收的 Msg 对象，_Wait_ms - 等待时间
+        // 返回：消息处理结果，仅 Rep、Respondent 协议作为回复的结果
         virtual Msg::_Ty_msg_result _On_message(Msg::_Ty_msg_code code, Msg& msg, nng_duration& _Wait_ms) {
             return _On_message(code, msg);
         }
 
+        // 虚函数：处理回复（仅 Req 协议）
+        // 参数：code - 该回复所对应请求的消息代码，res - 回复的结果，msg - 回复消息（已裁剪结果），_Wait_ms - 等待时间
+        // 说明：多个请求同时在途时以 code 区分回复属于哪个请求；默认以 (结果, 回复消息) 交给 _On_message，与原有行为一致
+        virtual void _On_reply(Msg::_Ty_msg_code code, Msg::_Ty_msg_result res, Msg& msg, nng_duration& _Wait_ms) {
+            _On_message(res, msg, _Wait_ms);
+        }
+
         // 虚函数：处理等待状态
         // 参数：_Wait_ms - 等待时间
         virtual void _On_wait(nng_duration& _Wait_ms) {}
@@ -516,37 +915,297 @@ namespace nng
             _On_wait(_Wait_ms);
 
             if (_Wait_ms < 0) {
-                _Work_item->send();
+                _On_done(_Work_item);
             }
             else {
                 _Work_item->wait(_Wait_ms);
             }
         }
 
+        // 处理接收到的消息：设置了执行器时转交给执行器，否则直接处理
+        // 参数：_Work_item - 工作项指针
+        void _Post_message(PWORK_ITEM _Work_item) {
+            if (_My_executor) {
+                _My_offloaded.fetch_add(1);
+                Executor::Task _Task([this, _Work_item]() {
+                    _On_message(_Work_item);
+                    if (_My_offloaded.fetch_sub(1) == 1) {
+                        _My_offloaded.notify_all();
+                    }
+                });
+                if (_My_executor->post(std::move(_Task)) == NNG_OK) {
+                    return;
+                }
+                _Task();
+                return;
+            }
+            _On_message(_Work_item);
+        }
+
+        // 等待已转交给执行器的处理回调结束（阻塞等待计数归零，不占用 CPU）
+        // 说明：在执行器的工作线程中调用会等待自身，视为误用
+        void _Wait_offloaded() noexcept {
+            assert(!_My_executor || !_My_executor->in_worker() || _My_offloaded.load() == 0);
+            for (size_t _Count = _My_offloaded.load(); _Count != 0; _Count = _My_offloaded.load()) {
+                _My_offloaded.wait(_Count);
+            }
+        }
+
         // 处理接收到的消息
         // 参数：_Work_item - 工作项指针
         void _On_message(PWORK_ITEM _Work_item) {
             Msg& msg = _Work_item->_Msg;
             nng_duration _Wait_ms = -1;
             if (!_On_raw_message(msg, _Wait_ms)) {
-                Msg::_Ty_msg_code code = Msg::_Chop_msg_code(msg);
-                auto res = _On_message(code, msg, _Wait_ms);
-                Msg::_Append_msg_result(msg, res);
+                if constexpr (_Protocol_t::_Mode == CM_REQUEST) {
+                    Msg::_Ty_msg_result res = Msg::_Chop_msg_result(msg);
+                    _On_reply(_Work_item->_Request_code, res, msg, _Wait_ms);
+                }
+                else {
+                    Msg::_Ty_msg_code code = Msg::_Chop_msg_code(msg);
+                    auto res = _On_message(code, msg, _Wait_ms);
+                    if constexpr (_Protocol_t::_Mode == CM_REPLY) {
+                        Msg::_Append_msg_result(msg, res);
+                    }
+                }
+            }
+
+            if constexpr (_Protocol_t::_Mode == CM_REPLY) {
+                if (_Work_item->_Defer.load() != DS_NONE) {
+                    _On_deferred(_Work_item);
+                    return;
+                }
             }
 
             if (_Wait_ms < 0) {
-                _Work_item->send();
+                _On_done(_Work_item);
             }
             else {
                 _Work_item->wait(_Wait_ms);
             }
         }
 
+        // 工作项处理完一条消息：回复、继续接收或发送下一个请求
+        // 参数：_Work_item - 工作项指针
+        void _On_done(PWORK_ITEM _Work_item) {
+            if constexpr (_Protocol_t::_Mode == CM_REPLY) {
+                _Work_item->send();
+            }
+            else if constexpr (_Protocol_t::_Mode == CM_RECV) {
+                _Work_item->_Msg = Msg();
+                _Recv(_Work_item);
+            }
+            else {
+                _Work_item->_Msg = Msg();
+                _Request_next(_Work_item);
+            }
+        }
+
+        // 处理回调取得令牌后返回：令牌已完成时发送暂存的回复，否则交由令牌完成
+        // 参数：_Work_item - 工作项指针
+        void _On_deferred(PWORK_ITEM _Work_item) noexcept {
+            int _Expected = DS_PENDING;
+            if (_Work_item->_Defer.compare_exchange_strong(_Expected, DS_DETACHED)) {
+                return;
+            }
+
+            _Work_item->_Defer.store(DS_NONE);
+            _Complete_deferred(_Work_item, std::move(_Work_item->_Reply), _Work_item->_Reply_send);
+        }
+
+        // 令牌完成：处理回调已返回时立即完成，否则暂存回复，由 _On_deferred 完成
+        // 参数：_Work_item - 工作项指针，msg - 回复消息，send - true 发送回复，false 放弃回复
+        void _Finish_deferred(PWORK_ITEM _Work_item, Msg&& msg, bool send) noexcept {
+            int _Expected = DS_DETACHED;
+            if (_Work_item->_Defer.compare_exchange_strong(_Expected, DS_NONE)) {
+                _Complete_deferred(_Work_item, std::move(msg), send);
+                return;
+            }
+
+            _Work_item->_Reply = std::move(msg);
+            _Work_item->_Reply_send = send;
+            _Expected = DS_PENDING;
+            if (_Work_item->_Defer.compare_exchange_strong(_Expected, DS_DONE)) {
+                return;
+            }
+
+            // 处理回调恰好在此期间返回
+            _Work_item->_Defer.store(DS_NONE);
+            _Complete_deferred(_Work_item, std::move(_Work_item->_Reply), _Work_item->_Reply_send);
+        }
+
+        // 完成延迟回复：发送回复，或放弃回复后继续接收
+        // 参数：_Work_item - 工作项指针，msg - 回复消息，send - true 发送回复，false 放弃回复
+        void _Complete_deferred(PWORK_ITEM _Work_item, Msg&& msg, bool send) noexcept {
+            _Work_item->_Msg = Msg();
+            if (send) {
+                _Work_item->send(std::move(msg));
+            }
+            else {
+                _Recv(_Work_item);
+            }
+        }
+
+        // 工作项开始接收下一条消息，自动扩缩模式下记录开始时间、计入等待消息的工作项，并以空闲时间作为接收超时
+        // 参数：_Work_item - 工作项指针
+        void _Recv(PWORK_ITEM _Work_item) noexcept {
+            if (_My_scale_max != 0) {
+                _Work_item->_Recv_time = nng_clock();
+                _My_receiving.fetch_add(1);
+                _Work_item->_Aio.set_timeout(_My_scale_idle);
+            }
+            _Work_item->recv();
+        }
+
+        // 自动扩缩：工作项接收完成时询问 _On_autoscale，按结果增加或回收工作项
+        // 参数：_Work_item - 工作项指针，err - 接收结果
+        // 返回：true 表示工作项已被回收，调用方不再处理；false 表示照常处理接收结果
+        bool _Autoscale(PWORK_ITEM _Work_item, nng_err err) noexcept {
+            // 空闲超时只用于接收，回复的发送不受其限制
+            _Work_item->_Aio.set_timeout(NNG_DURATION_DEFAULT);
+            size_t _Receiving = _My_receiving.fetch_sub(1) - 1;
+            if (err != NNG_OK && err != NNG_ETIMEDOUT) {
+                return false;
+            }
+
+            AUTOSCALE_STATS _Stats;
+            _Stats._Event = err == NNG_OK ? AUTOSCALE_STATS::AE_RECV : AUTOSCALE_STATS::AE_IDLE;
+            _Stats._Active = _My_active.load();
+            _Stats._Receiving = _Receiving;
+            _Stats._Min = _My_scale_min;
+            _Stats._Max = _My_scale_max;
+            _Stats._Recv_wait = (nng_duration)(nng_clock() - _Work_item->_Recv_time);
+            int _Delta = _On_autoscale(_Stats);
+
+            if (_Stats._Event == AUTOSCALE_STATS::AE_RECV) {
+                if (_Delta > 0) {
+                    _Grow();
+                }
+                return false;
+            }
+
+            // 空闲超时：回收或继续接收，不作为异常处理
+            if (_Delta < 0) {
+                std::scoped_lock locker(_My_items_mtx);
+                if (_My_active.load() > _My_scale_min) {
+                    _My_active.fetch_sub(1);
+                    _Work_item->_State = WORK_ITEM::WIS_INIT;
+                    _My_parked_items.push_back(_Work_item);
+                    return true;
+                }
+            }
+            _Recv(_Work_item);
+            return true;
+        }
+
+        // 增加一个活动的工作项：优先复用已回收的工作项，否则新建
+        // 说明：新建失败（分配失败或 _On_dispatch_ctx 失败）时不留下未使用的工作项，本次不扩容
+        void _Grow() noexcept {
+            PWORK_ITEM _Work_item = nullptr;
+            {
+                std::scoped_lock locker(_My_items_mtx);
+                if (_My_active.load() >= _My_scale_max) {
+                    return;
+                }
+
+                if (!_My_parked_items.empty()) {
+                    _Work_item = _My_parked_items.back();
+                    _My_parked_items.pop_back();
+                }
+                else {
+                    try {
+                        auto& _Work_item_ref = _My_work_items.emplace_back(*this, _Callback, this);
+                        if (this->_On_dispatch_ctx(_Work_item_ref._Ctx) != NNG_OK) {
+                            // 上下文未完成配置，不能回收复用，直接移除（std::deque 移除末尾不影响其它工作项的地址）
+                            _My_work_items.pop_back();
+                            return;
+                        }
+                        _Work_item = &_Work_item_ref;
+                    }
+                    catch (const Exception&) {
+                        return;
+                    }
+                    catch (const std::bad_alloc&) {
+                        return;
+                    }
+                }
+                _My_active.fetch_add(1);
+            }
+            _Recv(_Work_item);
+        }
+
+        // 虚函数：自动扩缩策略
+        // 参数：stats - 决策依据
+        // 返回：大于 0 表示增加一个工作项；小于 0 表示回收触发事件的工作项（仅 AE_IDLE 事件）；0 表示不变
+        // 说明：在 aio 回调中调用，结果仍受上下限约束；默认在全部工作项都在处理且消息已在排队时扩容，空闲时回收
+        virtual int _On_autoscale(const AUTOSCALE_STATS& stats) {
+            if (stats._Event == AUTOSCALE_STATS::AE_IDLE) {
+                return stats._Active > stats._Min ? -1 : 0;
+            }
+            return stats._Receiving == 0 && stats._Recv_wait == 0 && stats._Active < stats._Max ? 1 : 0;
+        }
+
+        // 取下一个排队的请求交给工作项发送，没有请求时工作项转为空闲（仅 Req 协议）
+        // 参数：_Work_item - 工作项指针
+        void _Request_next(PWORK_ITEM _Work_item) noexcept {
+            Msg _Request;
+            {
+                std::scoped_lock locker(_My_request_mtx);
+                if (_My_requests.empty()) {
+                    _Work_item->_State = WORK_ITEM::WIS_INIT;
+                    _My_idle_items.push_back(_Work_item);
+                    return;
+                }
+                _Request = std::move(_My_requests.front());
+                _My_requests.pop_front();
+            }
+            _Send_request(_Work_item, std::move(_Request));
+        }
+
+        // 工作项发送请求，记录其消息代码（仅 Req 协议）
+        // 参数：_Work_item - 工作项指针，msg - 末尾带有消息代码的请求
+        void _Send_request(PWORK_ITEM _Work_item, Msg&& msg) noexcept {
+            MsgReader _Reader(msg);
+            _Reader.chop_u64(&_Work_item->_Request_code);
+            _Work_item->send(std::move(msg));
+        }
+
+        // 请求失败：发送失败时交回未发出的请求，接收回复失败时请求已发出
+        // 参数：_Work_item - 工作项指针，request - 未发出的请求（末尾带有消息代码），为空表示已发出，e - 错误码
+        void _Request_failed(PWORK_ITEM _Work_item, Msg&& request, nng_err e) noexcept {
+            if (request) {
+                request.chop(sizeof(Msg::_Ty_msg_code));
+            }
+            _On_request_failed(_Work_item->_Request_code, request, e);
+        }
+
+        // 虚函数：处理失败的请求（仅 Req 协议）
+        // 参数：code - 请求的消息代码，request - 未发出的请求（已去除消息代码），为空表示请求已发出但未收到回复，e - 错误码
+        // 说明：每个失败的请求调用一次，工作项随后继续发送排队的请求；默认交给 _On_exception
+        virtual void _On_request_failed(Msg::_Ty_msg_code code, Msg& request, nng_err e) {
+            _On_exception(e);
+        }
+
         // 虚函数：处理异常
         // 参数：e - 错误码
         virtual void _On_exception(nng_err e) {}
 
     protected:
-        std::vector<WORK_ITEM> _My_work_items;
+        std::deque<WORK_ITEM> _My_work_items;   // std::deque 保证工作项地址不变
+        std::mutex _My_items_mtx;               // 保护自动扩缩时工作项的增加和回收
+        std::vector<PWORK_ITEM> _My_parked_items;   // 自动扩缩回收的工作项
+        std::atomic<size_t> _My_active{ 0 };    // 活动的工作项数
+        std::atomic<size_t> _My_receiving{ 0 }; // 自动扩缩模式下正在等待消息的工作项数
+        size_t _My_scale_min = 0;               // 自动扩缩的工作项数下限
+        size_t _My_scale_max = 0;               // 自动扩缩的工作项数上限，0 表示未开启
+        nng_duration _My_scale_idle = 1000;     // 工作项空闲多久后可被回收（毫秒）
+        Executor* _My_executor = nullptr;       // 运行处理回调的执行器，为空时在 aio 回调线程中处理
+        std::atomic<size_t> _My_offloaded{ 0 }; // 已转交给执行器尚未结束的处理回调数
+        std::mutex _My_request_mtx;             // 保护 Req 协议的请求队列和空闲工作项
+        std::deque<Msg> _My_requests;           // Req 协议排队中的请求
+        std::vector<PWORK_ITEM> _My_idle_items; // Req 协议的空闲工作项
     };
+
+    // ResponseParallel 类：并行 Rep 协议类（使用 Listener 连接器的 ContextParallel）
+    using ResponseParallel = ContextParallel<ProtocolRep, Listener>;
 }
\ No newline at end of file